@@ -0,0 +1,235 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include "vcd_generator.h"
+
+#include "cli/options.h"
+#include "frame_generator.h"
+#include "import/vcd_parser.h"
+#include "util/latency_stats.h"
+#include "waveform/signal_store.h"
+#include "waveform/signal_viewer.h"
+
+namespace {
+    class results {
+    public:
+        void add(const std::string& name, const double value, const std::string& unit) {
+            m_entries.push_back({name, value, unit});
+        }
+
+        void add(const std::string& name, wavy::util::latency_stats& stats, const std::string& unit) {
+            add(name + ".mean", stats.mean(), unit);
+            add(name + ".p50", stats.percentile(0.5), unit);
+            add(name + ".p99", stats.percentile(0.99), unit);
+            add(name + ".max", stats.max(), unit);
+        }
+
+        void write(std::ostream& out, const wavy::bench::generator_config& config, const size_t trace_bytes) const {
+            out << "{\n";
+            out << "  \"config\": {\"signals\": " << config.signals << ", \"depth\": " << config.depth << ", \"max_bus_width\": " << config.max_bus_width;
+            out << ", \"bus_fraction\": " << config.bus_fraction << ", \"toggle_rate\": " << config.toggle_rate << ", \"clocks\": " << config.clocks;
+            out << ", \"clock_period\": " << config.clock_period << ", \"cycles\": " << config.cycles << ", \"seed\": " << config.seed;
+            out << ", \"trace_bytes\": " << trace_bytes << "},\n";
+            out << "  \"results\": [\n";
+            for (size_t i = 0; i < m_entries.size(); i++) {
+                const auto& e = m_entries[i];
+                out << "    {\"name\": \"" << e.name << "\", \"value\": " << e.value << ", \"unit\": \"" << e.unit << "\"}";
+                out << (i + 1 < m_entries.size() ? ",\n" : "\n");
+            }
+            out << "  ]\n";
+            out << "}\n";
+        }
+    private:
+        struct entry {
+            std::string name;
+            double value;
+            std::string unit;
+        };
+
+        std::vector<entry> m_entries;
+    };
+
+    class stopwatch {
+    public:
+        stopwatch() : m_start(std::chrono::steady_clock::now()) {}
+
+        double seconds() const {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+        }
+
+        double microseconds() const {
+            return seconds() * 1e6;
+        }
+    private:
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    template<typename T>
+    double ingest(const std::string& text, T& sink) {
+        wavy::import::vcd_parser<T> parser;
+        parser.set_sink(sink);
+
+        std::istringstream in(text);
+        std::string line;
+
+        stopwatch watch;
+        while (std::getline(in, line)) {
+            parser.parse_line(line);
+        }
+        return watch.seconds();
+    }
+}
+
+int main(const int argc, const char** args) {
+    wavy::cli::options opts(std::vector<std::string>(args + 1, args + argc));
+    wavy::bench::generator_config config;
+
+    config.signals = opts.number<size_t>("signals").value_or(config.signals);
+    config.depth = opts.number<size_t>("depth").value_or(config.depth);
+    config.max_bus_width = opts.number<size_t>("bus-width").value_or(config.max_bus_width);
+    config.bus_fraction = opts.number<double>("bus-fraction").value_or(config.bus_fraction);
+    config.toggle_rate = opts.number<double>("toggle-rate").value_or(config.toggle_rate);
+    config.clocks = opts.number<size_t>("clocks").value_or(config.clocks);
+    config.clock_period = opts.number<size_t>("clock-period").value_or(config.clock_period);
+    config.cycles = opts.number<size_t>("cycles").value_or(config.cycles);
+    config.seed = opts.number<uint64_t>("seed").value_or(config.seed);
+
+    if (auto path = opts.get("generate")) {
+        std::ofstream out(*path);
+        wavy::bench::vcd_generator(config).write(out);
+        return 0;
+    }
+
+    std::stringstream trace;
+    wavy::bench::vcd_generator(config).write(trace);
+    auto text = trace.str();
+    auto megabytes = text.size() / 1e6;
+
+    results r;
+    std::mt19937_64 random(config.seed);
+
+    {
+        wavy::frame_generator fg;
+        r.add("ingest.frame_generator", megabytes / ingest(text, fg), "MB/s");
+
+        stopwatch watch;
+        fg.finalize();
+        r.add("init_tree", watch.seconds() * 1e3, "ms");
+    }
+
+    wavy::waveform::signal_store<uint64_t> store;
+    r.add("ingest.signal_store", megabytes / ingest(text, store), "MB/s");
+    store.finalize();
+
+    auto max_time = store.max_time();
+    for (size_t i = 0; i < store.size(); i++) {
+        store.data(i).activate(max_time);
+    }
+
+    {
+        constexpr size_t num_seeks = 100000;
+        std::vector<std::pair<size_t, size_t>> targets;
+        for (size_t i = 0; i < num_seeks; i++) {
+            targets.push_back({random() % store.size(), random() % (max_time + 1)});
+        }
+
+        size_t checksum = 0;
+        stopwatch watch;
+        for (const auto& [index, time] : targets) {
+            auto pos = store.data(index).position();
+            pos.seek(time * 1024);
+            checksum += pos.item();
+        }
+        r.add("seek", watch.microseconds() * 1e3 / num_seeks, "ns");
+        r.add("seek.checksum", checksum, "items");
+    }
+
+    {
+        constexpr size_t columns = 200;
+        auto rows = std::min<size_t>(store.size(), 200);
+        std::vector<std::pair<std::string, size_t>> zoom_levels = {
+            {"0.25", 256},
+            {"1", 1024},
+            {"16", 16 * 1024},
+            {"256", 256 * 1024},
+            {"fit", std::max<size_t>(1, max_time * 1024 / columns)}
+        };
+
+        for (const auto& [name, scale] : zoom_levels) {
+            auto span = max_time * 1024 / scale;
+            stopwatch watch;
+
+            for (size_t i = 0; i < rows; i++) {
+                auto& w = store.data(i).drawn_wave();
+                w.set_view(scale, span > columns ? random() % (span - columns) : 0);
+                w.set_frame(columns);
+                w.set_frame(0);
+            }
+
+            r.add("draw_frame.ticks_per_column_" + name, watch.microseconds() / rows, "us/row");
+        }
+    }
+
+    for (size_t i = 0; i < store.size(); i++) {
+        store.data(i).deactivate();
+    }
+
+    {
+        wavy::waveform::signal_viewer<uint64_t> viewer;
+        auto rows = std::min<size_t>(store.size(), 64);
+
+        viewer.set_frame(200, 60);
+        stopwatch add_watch;
+        for (size_t i = 0; i < rows; i++) {
+            viewer.add_signal(i, max_time, store.name(i), &store.data(i));
+        }
+        r.add("signal_viewer.add_signal", add_watch.microseconds() / rows, "us");
+
+        auto measure = [&](const std::string& name, auto action) {
+            wavy::util::latency_stats stats;
+            for (size_t i = 0; i < 500; i++) {
+                stopwatch watch;
+                action(i);
+                stats.add(watch.microseconds());
+            }
+            r.add("keypress." + name, stats, "us");
+        };
+
+        viewer.goto_time(max_time * 512);
+        measure("move_right", [&](size_t) {
+            viewer.move_right();
+        });
+        measure("move_left", [&](size_t) {
+            viewer.move_left();
+        });
+        measure("zoom", [&](size_t i) {
+            if ((i % 2) == 0) {
+                viewer.zoom_out();
+            } else {
+                viewer.zoom_in();
+            }
+        });
+        measure("move_down", [&](size_t i) {
+            if ((i / rows) % 2 == 0) {
+                viewer.move_down();
+            } else {
+                viewer.move_up();
+            }
+        });
+        measure("goto", [&](size_t) {
+            viewer.goto_time((random() % (max_time + 1)) * 1024);
+        });
+    }
+
+    if (auto path = opts.get("output")) {
+        std::ofstream out(*path);
+        r.write(out, config, text.size());
+    } else {
+        r.write(std::cout, config, text.size());
+    }
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace wavy::bench {
+    struct generator_config {
+        size_t signals = 1000;
+        size_t depth = 4;
+        size_t max_bus_width = 64;
+        double bus_fraction = 0.3;
+        double toggle_rate = 0.1;
+        size_t clocks = 2;
+        size_t clock_period = 10;
+        size_t cycles = 10000;
+        uint64_t seed = 1;
+    };
+
+    class vcd_generator {
+    public:
+        vcd_generator(const generator_config& config) : m_config(config), m_random(config.seed) {
+            create_signals();
+        }
+
+        void write(std::ostream& out) {
+            write_header(out);
+            write_data(out);
+        }
+    private:
+        struct generated_signal {
+            std::vector<std::string> scope;
+            std::string name;
+            std::string id;
+            size_t width;
+            size_t period;
+        };
+
+        void create_signals() {
+            auto fanout = std::max<size_t>(2, static_cast<size_t>(std::pow(m_config.signals, 1.0 / std::max<size_t>(1, m_config.depth + 1))));
+
+            for (size_t i = 0; i < m_config.signals; i++) {
+                generated_signal s;
+                s.scope.push_back("top");
+
+                for (size_t level = 0; level < m_config.depth; level++) {
+                    s.scope.push_back("u" + std::to_string(m_random() % fanout));
+                }
+
+                if (i < m_config.clocks) {
+                    s.name = "clk" + std::to_string(i);
+                    s.width = 1;
+                    s.period = m_config.clock_period * (i + 1);
+                } else {
+                    s.name = "sig" + std::to_string(i);
+                    s.width = 1;
+                    s.period = 0;
+
+                    if (std::uniform_real_distribution<double>(0, 1)(m_random) < m_config.bus_fraction && m_config.max_bus_width > 1) {
+                        s.width = 2 + m_random() % (m_config.max_bus_width - 1);
+                    }
+                }
+
+                s.id = identifier(i);
+                m_signals.push_back(s);
+            }
+
+            std::sort(m_signals.begin(), m_signals.end(), [](const generated_signal& l, const generated_signal& r) {
+                return l.scope < r.scope;
+            });
+        }
+
+        std::string identifier(size_t n) const {
+            std::string result;
+            do {
+                result += static_cast<char>(33 + n % 94);
+                n /= 94;
+            } while (n > 0);
+            return result;
+        }
+
+        std::string full_name(const generated_signal& s) const {
+            std::string result;
+            for (const auto& scope : s.scope) {
+                result += scope + ".";
+            }
+            return result + s.name;
+        }
+
+        void write_header(std::ostream& out) {
+            std::vector<std::string> current;
+
+            out << "$timescale 1ns $end\n";
+            for (const auto& s : m_signals) {
+                size_t common = 0;
+                while (common < current.size() && common < s.scope.size() && current[common] == s.scope[common]) {
+                    common++;
+                }
+                for (auto i = current.size(); i > common; i--) {
+                    out << "$upscope $end\n";
+                }
+                for (auto i = common; i < s.scope.size(); i++) {
+                    out << "$scope module " << s.scope[i] << " $end\n";
+                }
+                current = s.scope;
+
+                out << "$var wire " << s.width << " " << s.id << " " << full_name(s) << " $end\n";
+            }
+            for (size_t i = 0; i < current.size(); i++) {
+                out << "$upscope $end\n";
+            }
+            out << "$enddefinitions $end\n";
+        }
+
+        std::string random_value(const size_t width) {
+            std::string result(width, '0');
+            for (auto& c : result) {
+                c = '0' + (m_random() & 1);
+            }
+            return "b" + result + " ";
+        }
+
+        void write_value(std::ostream& out, const generated_signal& s, const bool high) {
+            if (s.width == 1) {
+                out << (high ? '1' : '0') << s.id << "\n";
+            } else {
+                out << random_value(s.width) << s.id << "\n";
+            }
+        }
+
+        void write_data(std::ostream& out) {
+            std::uniform_real_distribution<double> toggle(0, 1);
+            std::vector<bool> state(m_signals.size(), false);
+
+            out << "#0\n$dumpvars\n";
+            for (const auto& s : m_signals) {
+                write_value(out, s, false);
+            }
+            out << "$end\n";
+
+            auto half_period = std::max<size_t>(1, m_config.clock_period / 2);
+            auto end = m_config.cycles * m_config.clock_period;
+
+            for (size_t time = half_period; time < end; time += half_period) {
+                bool stamped = false;
+                auto stamp = [&]() {
+                    if (!stamped) {
+                        out << "#" << time << "\n";
+                        stamped = true;
+                    }
+                };
+
+                for (size_t i = 0; i < m_signals.size(); i++) {
+                    const auto& s = m_signals[i];
+
+                    if (s.period > 0) {
+                        if (time % std::max<size_t>(1, s.period / 2) == 0) {
+                            stamp();
+                            state[i] = !state[i];
+                            write_value(out, s, state[i]);
+                        }
+                    } else if (time % m_config.clock_period == 0 && toggle(m_random) < m_config.toggle_rate) {
+                        stamp();
+                        state[i] = !state[i];
+                        write_value(out, s, state[i]);
+                    }
+                }
+            }
+        }
+
+        generator_config m_config;
+        std::mt19937_64 m_random;
+        std::vector<generated_signal> m_signals;
+    };
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <poll.h>
+#include <unistd.h>
+
+namespace cmd {
+    class input_reader {
+    public:
+        input_reader() : m_thread([this]() { run(); }) {}
+
+        ~input_reader() {
+            m_stop = true;
+            m_thread.join();
+        }
+
+        std::string wait(const std::chrono::milliseconds timeout) {
+            std::unique_lock ul(m_mutex);
+            m_cv.wait_for(ul, timeout, [this]() {
+                return !m_buffer.empty() || m_closed;
+            });
+
+            std::string result;
+            std::swap(result, m_buffer);
+            return result;
+        }
+
+        bool closed() const {
+            return m_closed;
+        }
+    private:
+        void run() {
+            while (!m_stop) {
+                pollfd fd = {STDIN_FILENO, POLLIN, 0};
+                if (poll(&fd, 1, 50) <= 0) {
+                    continue;
+                }
+
+                char buffer[256];
+                auto n = read(STDIN_FILENO, buffer, sizeof(buffer));
+
+                if (n > 0) {
+                    std::unique_lock ul(m_mutex);
+                    m_buffer.append(buffer, n);
+                } else if (n == 0) {
+                    m_closed = true;
+                }
+                m_cv.notify_all();
+
+                if (m_closed) {
+                    return;
+                }
+            }
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::string m_buffer;
+        std::atomic<bool> m_closed = false;
+        std::atomic<bool> m_stop = false;
+        std::thread m_thread;
+    };
+}
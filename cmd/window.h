@@ -1,5 +1,6 @@
 #pragma once
 
+#include <csignal>
 #include <sys/ioctl.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -13,6 +14,27 @@ namespace cmd {
 
             return {ws.ws_col, ws.ws_row};
         }
+
+        namespace detail {
+            inline volatile std::sig_atomic_t resize_pending = 0;
+        }
+
+        inline void watch_resize() {
+            struct sigaction action = {};
+            action.sa_handler = [](int) {
+                detail::resize_pending = 1;
+            };
+            sigemptyset(&action.sa_mask);
+            sigaction(SIGWINCH, &action, nullptr);
+        }
+
+        inline bool resized() {
+            if (detail::resize_pending) {
+                detail::resize_pending = 0;
+                return true;
+            }
+            return false;
+        }
         namespace cursor {
             inline void up(const int n) {
                 std::cout << "\033[" + std::to_string(n) + "A";
@@ -34,6 +56,10 @@ namespace cmd {
             }
         }
 
+        inline void clear_line_end() {
+            std::cout << "\033[K";
+        }
+
         inline void clear() {
             auto [width, height] = size();
             for (int row = 0; row < height; row++) {
@@ -1,10 +1,56 @@
 #pragma once
 
+#include <chrono>
+#include <optional>
+#include <string>
+
+#include "input_reader.h"
 #include "window.h"
 
 namespace cmd {
+    namespace detail {
+        template<typename F>
+        std::optional<std::string> read_line(input_reader& reader, std::string& pending, size_t& next, F on_change) {
+            std::string line;
+
+            while (true) {
+                if (next == pending.size()) {
+                    pending = reader.wait(std::chrono::milliseconds(100));
+                    next = 0;
+
+                    if (pending.empty() && reader.closed()) {
+                        return std::nullopt;
+                    }
+                    continue;
+                }
+
+                auto c = pending[next++];
+
+                if (c == '\n' || c == '\r') {
+                    return line;
+                }
+                if (c == 0x1b) {
+                    return std::nullopt;
+                }
+                if (c == 0x7f || c == '\b') {
+                    if (!line.empty()) {
+                        line.pop_back();
+                        on_change(line);
+                    }
+                    continue;
+                }
+
+                line += c;
+                on_change(line);
+            }
+        }
+    }
+
     template<typename T>
     void write_screen(T& frame_generator) {
+        constexpr auto frame_interval = std::chrono::milliseconds(16);
+        constexpr auto idle_interval = std::chrono::milliseconds(250);
+
         auto old_settings = window::read_terminal_settings();
         auto new_settings = old_settings;
         new_settings.disable_canonical();
@@ -12,36 +58,96 @@ namespace cmd {
 
         window::write_terminal_settings(new_settings);
         window::cursor::hide();
+        window::watch_resize();
+
+        auto [columns, rows] = window::size();
+        frame_generator.set_frame(columns, rows);
+
+        input_reader reader;
+        std::string pending;
+        size_t next = 0;
+        bool redraw = true;
+        auto last_frame = std::chrono::steady_clock::now() - frame_interval;
+
+        auto render = [&]() {
+            auto start = std::chrono::steady_clock::now();
+            auto frame = frame_generator.frame();
+            auto composed = std::chrono::steady_clock::now();
+
+            window::cursor::up(rows);
+            std::cout << frame << '\r' << std::flush;
+
+            last_frame = std::chrono::steady_clock::now();
+            redraw = false;
+
+            frame_generator.finish_frame(
+                std::chrono::duration<double, std::micro>(composed - start).count(),
+                std::chrono::duration<double, std::micro>(last_frame - composed).count()
+            );
+        };
 
-        char input = 0;
         while (true) {
-            auto [columns, rows] = window::size();
-            frame_generator.set_frame(columns, rows);
+            if (next == pending.size()) {
+                auto timeout = idle_interval;
+                if (redraw) {
+                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - last_frame);
+                    timeout = std::max(std::chrono::milliseconds(0), frame_interval - elapsed);
+                }
 
-            if (auto enter_line = frame_generator.update_frame(input)) {
-                window::cursor::up(rows);
+                pending = reader.wait(timeout);
+                next = 0;
+
+                if (pending.empty() && reader.closed()) {
+                    break;
+                }
+            }
+
+            if (window::resized()) {
+                std::tie(columns, rows) = window::size();
+                frame_generator.set_frame(columns, rows);
+                redraw = true;
+            }
+
+            if (next < pending.size()) {
+                auto input = pending[next];
+                size_t count = 1;
+
+                if (frame_generator.repeatable(input)) {
+                    while (next + count < pending.size() && pending[next + count] == input) {
+                        count++;
+                    }
+                }
+                next += count;
+
+                auto enter_line = frame_generator.update_frame(input, count);
+                if (!enter_line) {
+                    break;
+                }
+                redraw = true;
 
                 if (*enter_line) {
+                    window::cursor::up(rows);
                     std::cout << frame_generator.frame() << std::flush;
-                    window::write_terminal_settings(old_settings);
                     window::cursor::show();
 
-                    std::string command;
+                    auto command = detail::read_line(reader, pending, next, [&](const std::string& line) {
+                        frame_generator.update_command(line);
+
+                        std::cout << '\r';
+                        window::cursor::up(rows);
+                        std::cout << frame_generator.frame() << line;
+                        window::clear_line_end();
+                        std::cout << std::flush;
+                    });
+                    frame_generator.execute_command(command.value_or(""));
 
-                    std::cin >> command;
-                    frame_generator.execute_command(command);
-                    window::cursor::up(1);
-                                        
-                    window::write_terminal_settings(new_settings);
                     window::cursor::hide();
-                } else {
-                    std::cout << frame_generator.frame() << '\r' << std::flush;
                 }
-            } else {
-                break;
             }
 
-            input = getchar();
+            if (redraw && std::chrono::steady_clock::now() - last_frame >= frame_interval) {
+                render();
+            }
         }
 
         window::write_terminal_settings(old_settings);
@@ -1,6 +1,8 @@
 #include <fstream>
 
 #include "import/vcd_parser.h"
+#include "cli/commands.h"
+#include "cli/options.h"
 #include "frame_generator.h"
 
 int main(const int argc, const char** args) {
@@ -10,6 +12,30 @@ int main(const int argc, const char** args) {
     }
 
     std::string filename(args[1]);
+    std::vector<std::string> arguments(args + 2, args + argc);
+
+    if (filename == "render") {
+        return wavy::cli::render(arguments);
+    }
+    if (filename == "replay") {
+        return wavy::cli::replay(arguments);
+    }
+    if (filename == "diff") {
+        return wavy::cli::diff(arguments);
+    }
+    if (filename == "query") {
+        return wavy::cli::query(arguments);
+    }
+    if (filename == "serve") {
+        return wavy::cli::serve(arguments);
+    }
+    if (filename == "attach") {
+        return wavy::cli::attach(arguments);
+    }
+    if (filename == "export") {
+        return wavy::cli::export_vcd(arguments);
+    }
+
     std::ifstream infile(filename);
 
     if (infile.good()) {
@@ -28,8 +54,17 @@ int main(const int argc, const char** args) {
         std::cout << "Read complete" << std::endl;
 
         fg.finalize();
-        
+
+        wavy::cli::options opts(arguments);
+        auto profile = opts.get("profile");
+        fg.set_profiling(profile.has_value());
+
         cmd::write_screen(fg);
+
+        if (profile) {
+            std::ofstream out(*profile);
+            fg.write_profile(out);
+        }
     } else {
         std::cout << "Did not find " << filename << std::endl;
         return -1;
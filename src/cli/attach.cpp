@@ -0,0 +1,94 @@
+#include "commands.h"
+
+#include <iostream>
+#include <unordered_set>
+
+#include "options.h"
+#include "unix_socket.h"
+
+#include "frame_generator.h"
+
+namespace wavy::cli {
+    namespace {
+        std::optional<std::vector<std::string>> ask(unix_socket& server, const std::string& request) {
+            if (!server.write(request + "\n")) {
+                return std::nullopt;
+            }
+
+            std::vector<std::string> rows;
+            while (auto line = server.read_line()) {
+                if (line->empty()) {
+                    return rows;
+                }
+                rows.push_back(*line);
+            }
+            return std::nullopt;
+        }
+
+        std::pair<std::string, std::string> last_fields(const std::string& row) {
+            auto value = row.rfind(',');
+            auto middle = row.rfind(',', value - 1);
+            return {row.substr(middle + 1, value - middle - 1), row.substr(value + 1)};
+        }
+    }
+
+    int attach(const std::vector<std::string>& args) {
+        options opts(args);
+
+        auto list = opts.get("signals");
+        if (opts.positional().size() != 1 || !list) {
+            std::cerr << "Usage: wavy attach <socket> --signals <list>" << std::endl;
+            return -1;
+        }
+
+        std::unordered_set<std::string> wanted;
+        for (const auto& name : read_name_list(*list)) {
+            wanted.insert(name);
+        }
+        if (wanted.empty()) {
+            std::cerr << "No signals listed in " << *list << std::endl;
+            return -1;
+        }
+
+        auto server = unix_socket::connect(opts.positional()[0]);
+        if (!server || !ask(*server, "format csv") || !ask(*server, "radix bin")) {
+            std::cerr << "Could not connect to " << opts.positional()[0] << std::endl;
+            return -1;
+        }
+
+        auto signals = ask(*server, "signals");
+        if (!signals) {
+            std::cerr << "Lost connection" << std::endl;
+            return -1;
+        }
+
+        frame_generator fg;
+        std::vector<std::pair<size_t, std::string>> fetched;
+        for (const auto& row : *signals) {
+            auto [empty, width] = last_fields(row);
+            auto name = row.substr(row.find(',') + 1, row.length() - width.length() - row.find(',') - 3);
+            if (wanted.contains(name)) {
+                fetched.push_back({fg.add_signal(name, util::parse_number<size_t>(width).value_or(1)), name});
+            }
+        }
+
+        for (const auto& [index, name] : fetched) {
+            auto transitions = ask(*server, "transitions " + name);
+            if (!transitions) {
+                std::cerr << "Lost connection" << std::endl;
+                return -1;
+            }
+            for (const auto& transition : *transitions) {
+                auto [time, value] = last_fields(transition);
+                if (auto t = util::parse_number<size_t>(time)) {
+                    fg.add_transition(index, value, *t);
+                }
+            }
+        }
+        fg.finalize();
+
+        cmd::write_screen(fg);
+
+        return 0;
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace wavy::cli {
+    int render(const std::vector<std::string>& args);
+    int replay(const std::vector<std::string>& args);
+    int diff(const std::vector<std::string>& args);
+    int query(const std::vector<std::string>& args);
+    int serve(const std::vector<std::string>& args);
+    int attach(const std::vector<std::string>& args);
+    int export_vcd(const std::vector<std::string>& args);
+}
@@ -0,0 +1,250 @@
+#include "commands.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "options.h"
+
+#include "frame_generator.h"
+#include "import/vcd_parser.h"
+#include "util/parallel_for.h"
+#include "waveform/signal_store.h"
+#include "waveform/value_format.h"
+
+namespace wavy::cli {
+    namespace {
+        struct compared_signal {
+            std::string name;
+            waveform::signal<uint64_t>* golden;
+            waveform::signal<uint64_t>* test;
+            std::optional<size_t> divergence;
+        };
+
+        template<typename T>
+        class prefixed_sink {
+        public:
+            prefixed_sink(T& sink, const std::string& prefix) : m_sink(sink), m_prefix(prefix) {}
+
+            size_t add_signal(const std::string& name, const size_t width) {
+                return m_sink.add_signal(m_prefix + name, width);
+            }
+
+            void add_transition(const size_t index, const std::string& value, const size_t time) {
+                m_max_time = std::max(m_max_time, time);
+                m_sink.add_transition(index, value, time);
+            }
+
+            size_t max_time() const {
+                return m_max_time;
+            }
+        private:
+            T& m_sink;
+            std::string m_prefix;
+            size_t m_max_time = 0;
+        };
+
+        struct matched_signals {
+            std::vector<compared_signal> signals;
+            std::vector<std::string> only_golden;
+            std::vector<std::string> only_test;
+            std::vector<std::string> ambiguous;
+        };
+
+        template<typename F, typename G>
+        matched_signals match(const std::vector<std::string>& golden_names, const std::vector<std::string>& test_names, F golden_signal, G test_signal) {
+            std::unordered_map<std::string, size_t> golden_count;
+            std::unordered_map<std::string, size_t> test_count;
+            std::unordered_set<std::string> done;
+            matched_signals result;
+
+            for (const auto& name : golden_names) {
+                golden_count[name]++;
+            }
+            for (const auto& name : test_names) {
+                test_count[name]++;
+            }
+
+            for (const auto& name : golden_names) {
+                if (!done.insert(name).second) {
+                    continue;
+                }
+                if (!test_count.contains(name)) {
+                    result.only_golden.push_back(name);
+                } else if (golden_count[name] > 1 || test_count[name] > 1) {
+                    result.ambiguous.push_back(name);
+                } else {
+                    result.signals.push_back({name, golden_signal(name), test_signal(name), std::nullopt});
+                }
+            }
+            for (const auto& name : test_names) {
+                if (!golden_count.contains(name) && done.insert(name).second) {
+                    result.only_test.push_back(name);
+                }
+            }
+
+            return result;
+        }
+
+        void compare(std::vector<compared_signal>& signals, const size_t golden_max_time, const size_t test_max_time) {
+            auto end = (std::min(golden_max_time, test_max_time) + 1) * 1024;
+
+            util::parallel_for(signals.size(), [&](const size_t i) {
+                signals[i].divergence = signals[i].golden->first_difference(*signals[i].test, end);
+            });
+
+            std::stable_sort(signals.begin(), signals.end(), [](const compared_signal& l, const compared_signal& r) {
+                return l.divergence.value_or(SIZE_MAX) < r.divergence.value_or(SIZE_MAX);
+            });
+        }
+
+        size_t report(std::ostream& out, const matched_signals& matched, const std::string& golden_name, const size_t golden_max_time, const std::string& test_name, const size_t test_max_time) {
+            size_t diverging = 0;
+            for (const auto& s : matched.signals) {
+                if (s.divergence) {
+                    out << waveform::format_time(*s.divergence) << " " << s.name << std::endl;
+                    diverging++;
+                }
+            }
+
+            auto ends_differ = golden_max_time != test_max_time;
+            if (ends_differ) {
+                auto golden_shorter = golden_max_time < test_max_time;
+                out << std::min(golden_max_time, test_max_time) << " end of " << (golden_shorter ? golden_name : test_name);
+                out << " (" << (golden_shorter ? test_name : golden_name) << " continues to " << std::max(golden_max_time, test_max_time) << ")" << std::endl;
+            }
+
+            for (const auto& name : matched.only_golden) {
+                out << "only in " << golden_name << ": " << name << std::endl;
+            }
+            for (const auto& name : matched.only_test) {
+                out << "only in " << test_name << ": " << name << std::endl;
+            }
+            for (const auto& name : matched.ambiguous) {
+                out << "ambiguous, declared more than once: " << name << std::endl;
+            }
+
+            out << matched.signals.size() - diverging << " identical, " << diverging << " diverging, ";
+            out << matched.only_golden.size() << " only in " << golden_name << ", " << matched.only_test.size() << " only in " << test_name << ", ";
+            out << matched.ambiguous.size() << " ambiguous" << (ends_differ ? ", different end times" : "") << std::endl;
+
+            return diverging + ends_differ + matched.only_golden.size() + matched.only_test.size() + matched.ambiguous.size();
+        }
+
+        int view(const std::string& golden_name, const std::string& test_name) {
+            frame_generator fg;
+            prefixed_sink<frame_generator> golden(fg, "golden.");
+            prefixed_sink<frame_generator> test(fg, "test.");
+
+            if (!import::parse_file(golden_name, golden) || !import::parse_file(test_name, test)) {
+                std::cerr << "Did not find " << golden_name << " or " << test_name << std::endl;
+                return -1;
+            }
+            fg.finalize();
+
+            std::vector<std::string> golden_names;
+            std::vector<std::string> test_names;
+            for (const auto& name : fg.signal_names()) {
+                if (name.starts_with("golden.")) {
+                    golden_names.push_back(name.substr(7));
+                } else if (name.starts_with("test.")) {
+                    test_names.push_back(name.substr(5));
+                }
+            }
+
+            auto matched = match(golden_names, test_names, [&](const std::string& name) {
+                return fg.find_signal("golden." + name);
+            }, [&](const std::string& name) {
+                return fg.find_signal("test." + name);
+            });
+            auto& signals = matched.signals;
+
+            for (auto& s : signals) {
+                s.golden->seal(golden.max_time());
+                s.test->seal(test.max_time());
+            }
+            compare(signals, golden.max_time(), test.max_time());
+            for (auto& s : signals) {
+                s.golden->unseal();
+                s.test->unseal();
+            }
+
+            std::vector<std::string> shown;
+            for (const auto& s : signals) {
+                if (s.divergence) {
+                    shown.push_back("golden." + s.name);
+                    shown.push_back("test." + s.name);
+                }
+            }
+
+            if (!shown.empty()) {
+                auto [columns, rows] = cmd::window::size();
+                fg.set_frame(columns, rows);
+                fg.show_signals(shown);
+                fg.update_frame(':');
+                fg.execute_command("goto " + std::to_string(*signals.front().divergence / 1024));
+                fg.update_frame(':');
+                fg.execute_command("mark diff");
+            }
+            cmd::write_screen(fg);
+
+            return report(std::cout, matched, golden_name, golden.max_time(), test_name, test.max_time()) > 0 ? 1 : 0;
+        }
+    }
+
+    int diff(const std::vector<std::string>& args) {
+        options opts(args, {"view"});
+
+        if (opts.positional().size() != 2) {
+            std::cerr << "Usage: wavy diff <golden.vcd> <test.vcd> [--view]" << std::endl;
+            return -1;
+        }
+
+        const auto& golden_name = opts.positional()[0];
+        const auto& test_name = opts.positional()[1];
+
+        if (opts.flag("view")) {
+            return view(golden_name, test_name);
+        }
+
+        waveform::signal_store<uint64_t> golden;
+        waveform::signal_store<uint64_t> test;
+        bool golden_found = false;
+
+        std::thread worker([&]() {
+            golden_found = import::parse_file(golden_name, golden);
+            golden.finalize();
+        });
+        auto test_found = import::parse_file(test_name, test);
+        test.finalize();
+        worker.join();
+
+        if (!golden_found || !test_found) {
+            std::cerr << "Did not find " << (golden_found ? test_name : golden_name) << std::endl;
+            return -1;
+        }
+
+        golden.seal_all();
+        test.seal_all();
+
+        std::vector<std::string> golden_names;
+        std::vector<std::string> test_names;
+        for (size_t i = 0; i < golden.size(); i++) {
+            golden_names.push_back(golden.name(i));
+        }
+        for (size_t i = 0; i < test.size(); i++) {
+            test_names.push_back(test.name(i));
+        }
+
+        auto matched = match(golden_names, test_names, [&](const std::string& name) {
+            return &golden.data(*golden.find(name));
+        }, [&](const std::string& name) {
+            return &test.data(*test.find(name));
+        });
+        compare(matched.signals, golden.max_time(), test.max_time());
+
+        return report(std::cout, matched, golden_name, golden.max_time(), test_name, test.max_time()) > 0 ? 1 : 0;
+    }
+}
@@ -0,0 +1,97 @@
+#include "commands.h"
+
+#include <fstream>
+#include <iostream>
+
+#include "options.h"
+
+#include "import/vcd_parser.h"
+#include "output/columns.h"
+#include "output/vcd_writer.h"
+#include "waveform/signal_store.h"
+
+namespace wavy::cli {
+    int export_vcd(const std::vector<std::string>& args) {
+        options opts(args);
+
+        if (opts.positional().size() != 1) {
+            std::cerr << "Usage: wavy export <trace.vcd> [--signals <list>] [--from <time>] [--to <time>] [--output <file>] [--format vcd|columns|csv] [--radix hex|dec|bin]" << std::endl;
+            return -1;
+        }
+
+        const auto& filename = opts.positional()[0];
+        waveform::signal_store<uint64_t> store;
+        std::vector<std::string> names;
+
+        if (auto list = opts.get("signals")) {
+            names = read_name_list(*list);
+            store.set_filter({names.begin(), names.end()});
+        }
+
+        if (!import::parse_file(filename, store)) {
+            std::cerr << "Did not find " << filename << std::endl;
+            return -1;
+        }
+        store.finalize();
+        store.seal_all();
+
+        std::vector<output::exported_signal<uint64_t>> signals;
+        for (size_t i = 0; i < store.size(); i++) {
+            signals.push_back({store.name(i), &store.data(i)});
+        }
+        for (const auto& name : names) {
+            if (!store.find(name)) {
+                std::cerr << "Unknown signal " << name << std::endl;
+            }
+        }
+
+        auto from = opts.number<size_t>("from").value_or(0);
+        auto to = opts.number<size_t>("to").value_or(store.max_time());
+        if (to < from) {
+            std::cerr << "Invalid time window" << std::endl;
+            return -1;
+        }
+
+        auto format = opts.get("format").value_or("vcd");
+        auto r = waveform::parse_radix(opts.get("radix").value_or("hex"));
+        if (format != "vcd" && format != "columns" && format != "csv") {
+            std::cerr << "Unknown format " << format << std::endl;
+            return -1;
+        }
+        if (!r) {
+            std::cerr << "Unknown radix " << *opts.get("radix") << std::endl;
+            return -1;
+        }
+
+        if (format == "columns") {
+            auto output = opts.get("output");
+            if (!output) {
+                std::cerr << "--format columns needs an --output directory" << std::endl;
+                return -1;
+            }
+            if (!output::write_columns(*output, signals, from, to, store.timescale())) {
+                std::cerr << "Could not write " << *output << std::endl;
+                return -1;
+            }
+            return 0;
+        }
+
+        std::ofstream outfile;
+        if (auto output = opts.get("output")) {
+            outfile.open(*output);
+            if (!outfile.good()) {
+                std::cerr << "Could not write " << *output << std::endl;
+                return -1;
+            }
+        }
+        std::ostream& out = outfile.is_open() ? outfile : std::cout;
+
+        if (format == "csv") {
+            output::write_transitions_csv(out, signals, from, to, *r);
+        } else {
+            output::write_vcd(out, signals, from, to, store.timescale());
+        }
+
+        return 0;
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <fstream>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "util/command_line.h"
+
+namespace wavy::cli {
+    class options {
+    public:
+        options(const std::vector<std::string>& args, const std::unordered_set<std::string>& flags = {}) {
+            for (size_t i = 0; i < args.size(); i++) {
+                if (args[i].starts_with("--")) {
+                    auto key = args[i].substr(2);
+
+                    if (flags.contains(key)) {
+                        m_flags.insert(key);
+                    } else if (i + 1 < args.size()) {
+                        m_values[key] = args[i + 1];
+                        i++;
+                    }
+                } else {
+                    m_positional.push_back(args[i]);
+                }
+            }
+        }
+
+        const std::vector<std::string>& positional() const {
+            return m_positional;
+        }
+
+        bool flag(const std::string& key) const {
+            return m_flags.contains(key);
+        }
+
+        std::optional<std::string> get(const std::string& key) const {
+            if (auto it = m_values.find(key); it != m_values.end()) {
+                return it->second;
+            }
+            return std::nullopt;
+        }
+
+        template<typename T>
+        std::optional<T> number(const std::string& key) const {
+            if (auto value = get(key)) {
+                return util::parse_number<T>(*value);
+            }
+            return std::nullopt;
+        }
+    private:
+        std::vector<std::string> m_positional;
+        std::unordered_map<std::string, std::string> m_values;
+        std::unordered_set<std::string> m_flags;
+    };
+
+    inline std::vector<std::string> read_name_list(const std::string& filename) {
+        std::vector<std::string> result;
+        std::ifstream infile(filename);
+
+        std::string line;
+        while (std::getline(infile, line)) {
+            for (const auto& name : util::split_by_space(line)) {
+                result.push_back(name);
+            }
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "output/snapshot.h"
+#include "util/command_line.h"
+#include "util/json.h"
+#include "waveform/signal_store.h"
+#include "waveform/value_filter.h"
+#include "waveform/value_format.h"
+
+namespace wavy::cli {
+    struct request {
+        std::string text;
+        std::vector<std::string> args;
+    };
+
+    struct answer {
+        std::string error;
+        std::vector<std::pair<size_t, std::string>> values;
+        std::vector<std::pair<std::string, std::string>> rows;
+        std::optional<size_t> count;
+    };
+
+    namespace detail {
+        inline bool high(const std::vector<uint64_t>& words) {
+            return !words.empty() && (words[0] & 1) != 0;
+        }
+
+        inline answer search(const request& q, const waveform::signal<uint64_t>& data, const waveform::radix r) {
+            const auto& args = q.args;
+            auto from = args.size() > 2 ? util::parse_number<size_t>(args[2]) : std::nullopt;
+            if (!from || args.size() < 4) {
+                return {"expected search <signal> <from> <expression>"};
+            }
+
+            std::string expression;
+            for (size_t i = 3; i < args.size(); i++) {
+                expression += args[i] + " ";
+            }
+
+            auto filter = waveform::value_filter<uint64_t>::parse(expression, data.width());
+            if (!filter) {
+                return {"invalid expression " + expression};
+            }
+
+            auto pos = data.position();
+            pos.seek(*from * 1024);
+
+            auto time = filter->matches(pos.words()) ? std::optional<size_t>(*from * 1024) : data.find_value(*filter, *from * 1024);
+            if (!time) {
+                return {};
+            }
+
+            pos.seek(*time);
+            return {"", {{*time / 1024, waveform::format_value(pos.words(), data.width(), r)}}};
+        }
+
+        inline answer render(const request& q, const waveform::signal_store<uint64_t>& store) {
+            const auto& args = q.args;
+            auto from = args.size() > 4 ? util::parse_number<size_t>(args[1]) : std::nullopt;
+            auto to = args.size() > 4 ? util::parse_number<size_t>(args[2]) : std::nullopt;
+            auto width = args.size() > 4 ? util::parse_number<size_t>(args[3]) : std::nullopt;
+            if (!from || !to || !width || *to <= *from || *width == 0 || *width > 4096) {
+                return {"expected render <from> <to> <width> <signal>..."};
+            }
+
+            std::vector<size_t> indices;
+            for (size_t i = 4; i < args.size(); i++) {
+                if (auto index = store.find(args[i])) {
+                    indices.push_back(*index);
+                } else {
+                    return {"unknown signal " + args[i]};
+                }
+            }
+
+            auto shot = output::render_snapshot(store, indices, *from, *to, *width);
+
+            answer result;
+            for (size_t i = 0; i < shot.rows.size(); i++) {
+                result.rows.push_back({shot.names[i], output::detail::replace_bit_symbols(shot.rows[i])});
+            }
+            return result;
+        }
+    }
+
+    inline std::vector<std::string> referenced_signals(const request& q) {
+        if (q.args.empty() || q.args[0] == "signals") {
+            return {};
+        }
+        if (q.args[0] == "render") {
+            return {q.args.begin() + std::min<size_t>(q.args.size(), 4), q.args.end()};
+        }
+        if (q.args.size() > 1) {
+            return {q.args[1]};
+        }
+        return {};
+    }
+
+    inline answer evaluate(const request& q, const waveform::signal_store<uint64_t>& store, const waveform::radix r) {
+        const auto& args = q.args;
+        if (args.empty()) {
+            return {"empty query"};
+        }
+
+        if (args[0] == "signals") {
+            answer result;
+            for (size_t i = 0; i < store.size(); i++) {
+                result.rows.push_back({store.name(i), std::to_string(store.data(i).width())});
+            }
+            return result;
+        }
+        if (args[0] == "render") {
+            return detail::render(q, store);
+        }
+
+        if (args.size() < 2) {
+            return {"missing signal"};
+        }
+
+        auto index = store.find(args[1]);
+        if (!index) {
+            return {"unknown signal " + args[1]};
+        }
+        const auto& data = store.data(*index);
+
+        if (args[0] == "search") {
+            return detail::search(q, data, r);
+        }
+
+        std::vector<size_t> times;
+        std::string edge = "rising";
+        for (size_t i = 2; i < args.size(); i++) {
+            if (auto time = util::parse_number<size_t>(args[i])) {
+                times.push_back(*time);
+            } else if (args[0] == "edges" && i == 2 && (args[i] == "rising" || args[i] == "falling" || args[i] == "any")) {
+                edge = args[i];
+            } else {
+                return {"invalid argument " + args[i]};
+            }
+        }
+
+        if (args[0] == "value") {
+            if (times.size() != 1) {
+                return {"expected value <signal> <time>"};
+            }
+
+            auto pos = data.position();
+            pos.seek(times[0] * 1024);
+            return {"", {{times[0], waveform::format_value(pos.words(), data.width(), r)}}};
+        }
+
+        if (times.size() != 0 && times.size() != 2) {
+            return {"expected a time range <from> <to>"};
+        }
+        auto from = times.empty() ? 0 : std::min(times[0], times[1]);
+        auto to = times.empty() ? store.max_time() : std::max(times[0], times[1]);
+
+        if (args[0] == "transitions") {
+            answer result;
+            auto pos = data.position();
+            pos.seek(from * 1024);
+
+            auto previous = pos;
+            auto changed = !previous.move_left() || previous.words() != pos.words();
+
+            while (pos.time() <= to * 1024) {
+                if (changed && pos.time() >= from * 1024) {
+                    result.values.push_back({pos.time() / 1024, waveform::format_value(pos.words(), data.width(), r)});
+                }
+
+                auto value = pos.words();
+                if (!pos.move_right()) {
+                    break;
+                }
+                changed = pos.words() != value;
+            }
+            return result;
+        }
+
+        if (args[0] == "edges") {
+            if (data.width() != 1) {
+                return {"edges needs a single-bit signal"};
+            }
+
+            auto base = from > 0 ? from - 1 : 0;
+            auto pos = data.position();
+            pos.seek(base * 1024);
+
+            auto toggles = data.activity(base, to).toggles;
+            auto rising = detail::high(pos.words()) ? toggles / 2 : (toggles + 1) / 2;
+
+            answer result;
+            result.count = edge == "any" ? toggles : edge == "rising" ? rising : toggles - rising;
+            return result;
+        }
+
+        return {"unknown query " + args[0]};
+    }
+
+    inline void write_json(std::ostream& out, const request& q, const answer& a) {
+        auto kind = q.args.empty() ? std::string() : q.args[0];
+
+        out << "{\"query\": \"" << util::escape_json(q.text) << "\"";
+        if (!a.error.empty()) {
+            out << ", \"error\": \"" << util::escape_json(a.error) << "\"";
+        } else if (a.count) {
+            out << ", \"count\": " << *a.count;
+        } else if (kind == "value" || kind == "search") {
+            if (a.values.empty()) {
+                out << ", \"time\": null";
+            } else {
+                out << ", \"time\": " << a.values[0].first << ", \"value\": \"" << a.values[0].second << "\"";
+            }
+        } else if (kind == "signals") {
+            out << ", \"signals\": [";
+            for (size_t i = 0; i < a.rows.size(); i++) {
+                out << (i > 0 ? ", " : "") << "{\"name\": \"" << util::escape_json(a.rows[i].first) << "\", \"width\": " << a.rows[i].second << "}";
+            }
+            out << "]";
+        } else if (kind == "render") {
+            out << ", \"rows\": [";
+            for (size_t i = 0; i < a.rows.size(); i++) {
+                out << (i > 0 ? ", " : "") << "{\"name\": \"" << util::escape_json(a.rows[i].first) << "\", \"wave\": \"" << util::escape_json(a.rows[i].second) << "\"}";
+            }
+            out << "]";
+        } else {
+            out << ", \"transitions\": [";
+            for (size_t i = 0; i < a.values.size(); i++) {
+                out << (i > 0 ? ", " : "") << "{\"time\": " << a.values[i].first << ", \"value\": \"" << a.values[i].second << "\"}";
+            }
+            out << "]";
+        }
+        out << "}";
+    }
+
+    inline void write_csv(std::ostream& out, const size_t index, const request& q, const answer& a) {
+        auto signal = q.args.size() > 1 ? q.args[1] : "";
+
+        if (!a.error.empty()) {
+            out << index << "," << signal << ",error," << a.error << "\n";
+        } else if (a.count) {
+            out << index << "," << signal << ",," << *a.count << "\n";
+        }
+        for (const auto& [time, value] : a.values) {
+            out << index << "," << signal << "," << time << "," << value << "\n";
+        }
+        for (const auto& [name, value] : a.rows) {
+            out << index << "," << name << ",," << value << "\n";
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#include "commands.h"
+
+#include <iostream>
+
+#include "options.h"
+#include "queries.h"
+
+#include "import/vcd_parser.h"
+#include "util/parallel_for.h"
+
+namespace wavy::cli {
+    int query(const std::vector<std::string>& args) {
+        options opts(args);
+
+        if (opts.positional().empty()) {
+            std::cerr << "Usage: wavy query <trace.vcd> [<query>...] [--queries <file>] [--format json|csv] [--radix hex|dec|bin]" << std::endl;
+            return -1;
+        }
+
+        std::vector<request> queries;
+        for (size_t i = 1; i < opts.positional().size(); i++) {
+            queries.push_back({opts.positional()[i], util::split_by_space(opts.positional()[i])});
+        }
+        if (auto list = opts.get("queries")) {
+            std::ifstream infile(*list);
+            if (!infile.good()) {
+                std::cerr << "Did not find " << *list << std::endl;
+                return -1;
+            }
+
+            std::string line;
+            while (std::getline(infile, line)) {
+                if (line.ends_with('\r')) {
+                    line.pop_back();
+                }
+                if (auto words = util::split_by_space(line); !words.empty()) {
+                    queries.push_back({line, words});
+                }
+            }
+        }
+
+        auto format = opts.get("format").value_or("json");
+        auto r = waveform::parse_radix(opts.get("radix").value_or("hex"));
+        if (format != "json" && format != "csv") {
+            std::cerr << "Unknown format " << format << std::endl;
+            return -1;
+        }
+        if (!r) {
+            std::cerr << "Unknown radix " << *opts.get("radix") << std::endl;
+            return -1;
+        }
+
+        const auto& filename = opts.positional()[0];
+        waveform::signal_store<uint64_t> store;
+
+        std::unordered_set<std::string> names;
+        auto lists_signals = false;
+        for (const auto& q : queries) {
+            lists_signals |= !q.args.empty() && q.args[0] == "signals";
+            for (const auto& name : referenced_signals(q)) {
+                names.insert(name);
+            }
+        }
+        if (!names.empty() && !lists_signals) {
+            store.set_filter(names);
+        }
+
+        if (!import::parse_file(filename, store)) {
+            std::cerr << "Did not find " << filename << std::endl;
+            return -1;
+        }
+        store.finalize();
+        store.seal_all();
+
+        std::vector<answer> answers(queries.size());
+        util::parallel_for(queries.size(), [&](const size_t i) {
+            answers[i] = evaluate(queries[i], store, *r);
+        });
+
+        if (format == "json") {
+            std::cout << "[\n";
+            for (size_t i = 0; i < queries.size(); i++) {
+                std::cout << "  ";
+                write_json(std::cout, queries[i], answers[i]);
+                std::cout << (i + 1 < queries.size() ? ",\n" : "\n");
+            }
+            std::cout << "]" << std::endl;
+        } else {
+            std::cout << "query,signal,time,value" << std::endl;
+            for (size_t i = 0; i < queries.size(); i++) {
+                write_csv(std::cout, i, queries[i], answers[i]);
+            }
+        }
+
+        for (const auto& a : answers) {
+            if (!a.error.empty()) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+}
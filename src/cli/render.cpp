@@ -0,0 +1,90 @@
+#include "commands.h"
+
+#include <fstream>
+#include <iostream>
+
+#include "options.h"
+
+#include "import/vcd_parser.h"
+#include "output/snapshot.h"
+#include "waveform/signal_store.h"
+
+namespace wavy::cli {
+    int render(const std::vector<std::string>& args) {
+        options opts(args);
+
+        if (opts.positional().size() != 1) {
+            std::cerr << "Usage: wavy render <trace.vcd> [--signals <list>] [--from <time>] [--to <time>] [--width <columns>] [--format ansi|txt|svg] [--output <file>]" << std::endl;
+            return -1;
+        }
+
+        const auto& filename = opts.positional()[0];
+        waveform::signal_store<uint64_t> store;
+        std::vector<std::string> names;
+
+        if (auto list = opts.get("signals")) {
+            names = read_name_list(*list);
+            store.set_filter({names.begin(), names.end()});
+        }
+
+        if (!import::parse_file(filename, store)) {
+            std::cerr << "Did not find " << filename << std::endl;
+            return -1;
+        }
+        store.finalize();
+        store.seal_all();
+
+        std::vector<size_t> indices;
+        if (names.empty()) {
+            for (size_t i = 0; i < store.size(); i++) {
+                indices.push_back(i);
+            }
+        } else {
+            for (const auto& name : names) {
+                if (auto index = store.find(name)) {
+                    indices.push_back(*index);
+                } else {
+                    std::cerr << "Unknown signal " << name << std::endl;
+                }
+            }
+        }
+
+        auto from = opts.number<size_t>("from").value_or(0);
+        auto to = opts.number<size_t>("to").value_or(store.max_time());
+        auto width = opts.number<size_t>("width").value_or(200);
+        auto format = opts.get("format").value_or("txt");
+
+        if (to <= from || width == 0) {
+            std::cerr << "Invalid time window or width" << std::endl;
+            return -1;
+        }
+        if (format != "ansi" && format != "txt" && format != "svg") {
+            std::cerr << "Unknown format " << format << std::endl;
+            return -1;
+        }
+
+        auto shot = output::render_snapshot(store, indices, from, to, width);
+
+        std::ofstream outfile;
+        if (auto output = opts.get("output")) {
+            outfile.open(*output);
+            if (!outfile.good()) {
+                std::cerr << "Could not write " << *output << std::endl;
+                return -1;
+            }
+        }
+        std::ostream& out = outfile.is_open() ? outfile : std::cout;
+
+        if (format == "ansi") {
+            output::write_ansi(out, shot);
+        }
+        if (format == "txt") {
+            output::write_txt(out, shot);
+        }
+        if (format == "svg") {
+            output::write_svg(out, shot);
+        }
+
+        return 0;
+    }
+}
@@ -0,0 +1,151 @@
+#include "commands.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#include "options.h"
+
+#include "frame_generator.h"
+#include "import/vcd_parser.h"
+#include "util/json.h"
+#include "util/latency_stats.h"
+
+namespace wavy::cli {
+    namespace {
+        struct command_stats {
+            util::latency_stats latency;
+            size_t bytes = 0;
+        };
+
+        std::optional<char> key_from_name(const std::string& name) {
+            if (name.length() == 1) {
+                return name[0];
+            }
+            if (name == "tab") {
+                return '\t';
+            }
+            if (name == "space") {
+                return ' ';
+            }
+            if (name == "enter") {
+                return '\n';
+            }
+            if (name == "left") {
+                return 0x44;
+            }
+            if (name == "right") {
+                return 0x43;
+            }
+            return std::nullopt;
+        }
+
+        std::string join(const std::vector<std::string>& args, const size_t first) {
+            std::string result;
+            for (auto i = first; i < args.size(); i++) {
+                result += (i > first ? " " : "") + args[i];
+            }
+            return result;
+        }
+    }
+
+    int replay(const std::vector<std::string>& args) {
+        options opts(args);
+
+        if (opts.positional().size() != 1 || !opts.get("script")) {
+            std::cerr << "Usage: wavy replay <trace.vcd> --script <keys> [--columns <n>] [--rows <n>] [--output <file>]" << std::endl;
+            return -1;
+        }
+
+        const auto& filename = opts.positional()[0];
+        std::ifstream script(*opts.get("script"));
+        if (!script.good()) {
+            std::cerr << "Did not find " << *opts.get("script") << std::endl;
+            return -1;
+        }
+
+        frame_generator fg;
+        if (!import::parse_file(filename, fg)) {
+            std::cerr << "Did not find " << filename << std::endl;
+            return -1;
+        }
+        fg.finalize();
+        fg.set_frame(opts.number<size_t>("columns").value_or(200), opts.number<size_t>("rows").value_or(50));
+
+        std::map<std::string, command_stats> stats;
+
+        auto measure = [&](const std::string& type, auto action) {
+            auto start = std::chrono::steady_clock::now();
+            action();
+            auto frame = fg.frame();
+            auto end = std::chrono::steady_clock::now();
+
+            auto& entry = stats[type];
+            entry.latency.add(std::chrono::duration<double, std::micro>(end - start).count());
+            entry.bytes += frame.size();
+        };
+
+        std::string line;
+        size_t line_number = 0;
+        while (std::getline(script, line)) {
+            line_number++;
+            auto words = util::split_by_space(line);
+
+            if (words.empty() || words[0].starts_with("#")) {
+                continue;
+            }
+
+            if (words[0] == "key" && (words.size() == 2 || words.size() == 3)) {
+                auto key = key_from_name(words[1]);
+                auto count = words.size() == 3 ? util::parse_number<size_t>(words[2]) : 1;
+
+                if (key && count) {
+                    for (size_t i = 0; i < *count; i++) {
+                        measure(words[1], [&]() {
+                            fg.update_frame(*key);
+                        });
+                    }
+                    continue;
+                }
+            }
+            if (words[0] == "search" && words.size() >= 2) {
+                measure("search", [&]() {
+                    fg.update_frame('/');
+                    fg.execute_command(join(words, 1));
+                });
+                continue;
+            }
+            if (words[0] == "command" && words.size() >= 2) {
+                measure(":" + words[1], [&]() {
+                    fg.update_frame(':');
+                    fg.execute_command(join(words, 1));
+                });
+                continue;
+            }
+
+            std::cerr << "Invalid script line " << line_number << ": " << line << std::endl;
+            return -1;
+        }
+
+        std::ofstream outfile;
+        if (auto output = opts.get("output")) {
+            outfile.open(*output);
+        }
+        std::ostream& out = outfile.is_open() ? outfile : std::cout;
+
+        out << "{\n  \"commands\": [\n";
+        size_t n = 0;
+        for (auto& [type, entry] : stats) {
+            out << "    {\"type\": \"" << util::escape_json(type) << "\", \"count\": " << entry.latency.count();
+            out << ", \"p50_us\": " << entry.latency.percentile(0.5);
+            out << ", \"p99_us\": " << entry.latency.percentile(0.99);
+            out << ", \"max_us\": " << entry.latency.max();
+            out << ", \"bytes_per_frame\": " << entry.bytes / std::max<size_t>(1, entry.latency.count()) << "}";
+            out << (++n < stats.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+
+        return 0;
+    }
+}
@@ -0,0 +1,127 @@
+#include "commands.h"
+
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <sstream>
+#include <thread>
+
+#include "options.h"
+#include "queries.h"
+#include "unix_socket.h"
+
+#include "import/vcd_parser.h"
+
+namespace wavy::cli {
+    namespace {
+        volatile std::sig_atomic_t stop_requested = 0;
+
+        void stop_on(const int signal) {
+            struct sigaction action = {};
+            action.sa_handler = [](int) {
+                stop_requested = 1;
+            };
+            sigemptyset(&action.sa_mask);
+            sigaction(signal, &action, nullptr);
+        }
+
+        struct connection {
+            explicit connection(unix_socket&& socket) : client(std::move(socket)) {}
+
+            unix_socket client;
+            std::thread worker;
+            std::atomic<bool> done = false;
+        };
+
+        void session(const waveform::signal_store<uint64_t>& store, unix_socket& client) {
+            auto csv = false;
+            auto r = waveform::radix::hex;
+            size_t index = 0;
+
+            while (auto line = client.read_line()) {
+                request q{*line, util::split_by_space(*line)};
+                std::stringstream response;
+
+                if (q.args.size() == 2 && q.args[0] == "format" && (q.args[1] == "json" || q.args[1] == "csv")) {
+                    csv = q.args[1] == "csv";
+                } else if (q.args.size() == 2 && q.args[0] == "radix" && waveform::parse_radix(q.args[1])) {
+                    r = *waveform::parse_radix(q.args[1]);
+                } else if (!q.args.empty()) {
+                    auto a = evaluate(q, store, r);
+                    if (csv) {
+                        write_csv(response, index, q, a);
+                    } else {
+                        write_json(response, q, a);
+                        response << "\n";
+                    }
+                    index++;
+                }
+                response << "\n";
+
+                if (!client.write(response.str())) {
+                    return;
+                }
+            }
+        }
+    }
+
+    int serve(const std::vector<std::string>& args) {
+        options opts(args);
+        auto path = opts.get("socket");
+
+        if (opts.positional().size() != 1 || !path) {
+            std::cerr << "Usage: wavy serve <trace.vcd> --socket <path>" << std::endl;
+            return -1;
+        }
+
+        const auto& filename = opts.positional()[0];
+        waveform::signal_store<uint64_t> store;
+
+        if (!import::parse_file(filename, store)) {
+            std::cerr << "Did not find " << filename << std::endl;
+            return -1;
+        }
+        store.finalize();
+        store.seal_all();
+
+        auto server = unix_socket::listen(*path);
+        if (!server) {
+            std::cerr << "Could not listen on " << *path << ": " << (errno == EEXIST ? "path exists" : std::strerror(errno)) << std::endl;
+            return -1;
+        }
+        std::cout << "Serving " << filename << " (" << store.size() << " signals) on " << *path << std::endl;
+
+        stop_on(SIGINT);
+        stop_on(SIGTERM);
+
+        std::list<connection> connections;
+        while (!stop_requested) {
+            if (auto client = server->accept()) {
+                auto& c = connections.emplace_back(std::move(*client));
+                c.worker = std::thread([&store, &c]() {
+                    session(store, c.client);
+                    c.done = true;
+                });
+            }
+
+            connections.remove_if([](connection& c) {
+                if (c.done) {
+                    c.worker.join();
+                    return true;
+                }
+                return false;
+            });
+        }
+
+        for (auto& c : connections) {
+            c.client.shutdown();
+        }
+        for (auto& c : connections) {
+            c.worker.join();
+        }
+
+        return 0;
+    }
+}
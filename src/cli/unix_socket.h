@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cerrno>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace wavy::cli {
+    class unix_socket {
+    public:
+        static std::optional<unix_socket> listen(const std::string& path) {
+            sockaddr_un address;
+            if (!make_address(path, address)) {
+                return std::nullopt;
+            }
+
+            struct stat existing;
+            if (::lstat(path.c_str(), &existing) == 0) {
+                if (!S_ISSOCK(existing.st_mode)) {
+                    errno = EEXIST;
+                    return std::nullopt;
+                }
+                ::unlink(path.c_str());
+            }
+
+            unix_socket result(::socket(AF_UNIX, SOCK_STREAM, 0));
+            if (result.m_fd < 0 || ::bind(result.m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                return std::nullopt;
+            }
+            result.m_path = path;
+
+            if (::listen(result.m_fd, SOMAXCONN) != 0) {
+                return std::nullopt;
+            }
+            return result;
+        }
+
+        static std::optional<unix_socket> connect(const std::string& path) {
+            sockaddr_un address;
+            if (!make_address(path, address)) {
+                return std::nullopt;
+            }
+
+            unix_socket result(::socket(AF_UNIX, SOCK_STREAM, 0));
+            if (result.m_fd < 0 || ::connect(result.m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                return std::nullopt;
+            }
+            return result;
+        }
+
+        unix_socket(unix_socket&& other) : m_fd(std::exchange(other.m_fd, -1)), m_path(std::move(other.m_path)), m_buffer(std::move(other.m_buffer)) {
+            other.m_path.clear();
+        }
+
+        unix_socket(const unix_socket&) = delete;
+        unix_socket& operator=(const unix_socket&) = delete;
+
+        ~unix_socket() {
+            if (m_fd >= 0) {
+                ::close(m_fd);
+            }
+            if (!m_path.empty()) {
+                ::unlink(m_path.c_str());
+            }
+        }
+
+        std::optional<unix_socket> accept() const {
+            auto fd = ::accept(m_fd, nullptr, nullptr);
+            if (fd < 0) {
+                return std::nullopt;
+            }
+            return unix_socket(fd);
+        }
+
+        void shutdown() {
+            ::shutdown(m_fd, SHUT_RDWR);
+        }
+
+        std::optional<std::string> read_line() {
+            while (true) {
+                if (auto end = m_buffer.find('\n'); end != std::string::npos) {
+                    auto line = m_buffer.substr(0, end);
+                    m_buffer.erase(0, end + 1);
+                    return line;
+                }
+
+                char chunk[4096];
+                auto n = ::read(m_fd, chunk, sizeof(chunk));
+                if (n <= 0) {
+                    return std::nullopt;
+                }
+                m_buffer.append(chunk, n);
+            }
+        }
+
+        bool write(const std::string& data) {
+            size_t written = 0;
+            while (written < data.size()) {
+                auto n = ::send(m_fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+                if (n <= 0) {
+                    return false;
+                }
+                written += n;
+            }
+            return true;
+        }
+    private:
+        explicit unix_socket(const int fd) : m_fd(fd) {}
+
+        static bool make_address(const std::string& path, sockaddr_un& address) {
+            address = {};
+            address.sun_family = AF_UNIX;
+            if (path.empty() || path.length() >= sizeof(address.sun_path)) {
+                return false;
+            }
+            path.copy(address.sun_path, path.length());
+            return true;
+        }
+
+        int m_fd;
+        std::string m_path;
+        std::string m_buffer;
+    };
+}
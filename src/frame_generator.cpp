@@ -1,13 +1,82 @@
 #include "frame_generator.h"
 
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+
+#include "output/vcd_writer.h"
+#include "util/command_line.h"
+#include "util/parallel_for.h"
+
 namespace wavy {
-    frame_generator::frame_generator() {}
+    namespace {
+        std::string format_bytes(const size_t bytes) {
+            std::stringstream sstream;
+            sstream << std::fixed << std::setprecision(1);
+
+            if (bytes >= (1UL << 30)) {
+                sstream << bytes / static_cast<double>(1UL << 30) << "GiB";
+            } else if (bytes >= (1UL << 20)) {
+                sstream << bytes / static_cast<double>(1UL << 20) << "MiB";
+            } else {
+                sstream << bytes / 1024.0 << "KiB";
+            }
+            return sstream.str();
+        }
+
+        std::string format_count(const size_t count) {
+            if (count < 10000) {
+                return std::to_string(count);
+            }
+
+            std::stringstream sstream;
+            auto value = static_cast<double>(count);
+            size_t unit = 0;
+            while (value >= 1000 && unit < 4) {
+                value /= 1000;
+                unit++;
+            }
+            sstream << std::fixed << std::setprecision(1) << value << " kMGT"[unit];
+            return sstream.str();
+        }
+
+        std::string format_activity(const util::activity& activity) {
+            std::stringstream duty;
+            duty << std::fixed << std::setprecision(1) << 100 * activity.duty() << "%";
+
+            std::stringstream sstream;
+            sstream << std::setw(8) << format_count(activity.toggles) << std::setw(7) << duty.str() << std::setw(8) << format_count(activity.high) << " ";
+            return sstream.str();
+        }
+    }
+
+    frame_generator::frame_generator() {
+        m_trace_viewer.set_profiler(&m_profiler);
+    }
 
     void frame_generator::finalize() {
+        create_buses();
+        m_buses.finish([this](const size_t index, const std::vector<uint64_t>& words, const size_t time) {
+            m_dir.node_data(index).add_transition(words, time);
+        });
         m_dir.init();
+
+        util::profiler::memory_counters memory;
+        memory.tree_nodes = m_dir.memory_usage();
+        for (size_t i = 0; i < m_dir.size(); i++) {
+            memory.value_words += m_dir.node_data(i).value_memory();
+            memory.time_deltas += m_dir.node_data(i).delta_memory();
+        }
+        m_profiler.set_memory(memory);
     }
 
     size_t frame_generator::add_signal(const std::string& name, const size_t width) {
+        if (width == 1) {
+            if (auto bit = m_buses.add_bit(name)) {
+                return *bit;
+            }
+        }
+
         auto index = m_dir.add_node(name);
         m_dir.node_data(index).init(width);
 
@@ -16,40 +85,152 @@ namespace wavy {
 
     void frame_generator::add_transition(const size_t index, const std::string& value, const size_t time) {
         m_max_transition_time = std::max(m_max_transition_time, time);
+
+        if (m_buses.contains(index)) {
+            create_buses();
+            m_buses.add_transition(index, value, time, [this](const size_t bus, const std::vector<uint64_t>& words, const size_t at) {
+                m_dir.node_data(bus).add_transition(words, at);
+            });
+            return;
+        }
         m_dir.node_data(index).add_transition(value, time);
     }
 
+    void frame_generator::set_timescale(const std::string& timescale) {
+        m_timescale = timescale;
+    }
+
+    void frame_generator::create_buses() {
+        m_buses.create([this](const std::string& name, const size_t width) {
+            auto index = m_dir.add_node(name);
+            m_dir.node_data(index).init(width);
+            return index;
+        });
+    }
+
     void frame_generator::set_frame(const size_t columns, const size_t rows) {
-        m_dir.set_frame(columns, rows - 1);
-        m_trace_viewer.set_frame(columns, rows - 1);
+        m_columns = columns;
+        m_rows = rows;
+
+        auto reserved = 1 + (m_show_hud ? hud_rows : 0);
+        auto view_rows = std::max(rows, reserved + 1) - reserved;
+
+        m_dir.set_frame(columns, view_rows);
+        m_trace_viewer.set_frame(columns, view_rows);
+        m_table.set_frame(columns, view_rows);
     }
 
     std::string frame_generator::frame() const {
+        std::string prompt;
+        if (m_prompt != 0) {
+            prompt += m_prompt;
+        }
+
+        std::string hud;
+        if (m_show_hud) {
+            hud = hud_frame();
+        }
+
         switch (m_current_view) {
-            case view::signal_selection: return m_dir.frame() + "$:>";
-            case view::signal_traces: return m_trace_viewer.frame() + "$G>";
+            case view::signal_selection: return hud + m_dir.frame() + (m_search_hits ? "$:" + std::to_string(*m_search_hits) + ">" : "$:>") + prompt;
+            case view::signal_traces: return hud + m_trace_viewer.frame() + (m_trace_viewer.readout_shown() ? "$G@" + waveform::format_time(m_trace_viewer.exact_cursor_time()) + ">" : "$G>") + prompt;
+            case view::cycle_table: return hud + m_table.frame() + "$T@" + waveform::format_time(m_table.cursor_time().value_or(0)) + ">" + prompt;
             default: return "";
         }
     }
 
-    std::optional<bool> frame_generator::update_frame(const char input) {
+    std::string frame_generator::hud_frame() const {
+        const auto& last = m_profiler.last();
+        const auto& memory = m_profiler.memory();
+        std::stringstream timing;
+        std::stringstream usage;
+
+        timing << std::fixed << std::setprecision(2);
+        timing << " frame " << last.total_us() / 1000 << "ms | draw " << last.draw_us / 1000 << "ms style " << last.style_us / 1000;
+        timing << "ms output " << last.output_us / 1000 << "ms | transitions " << last.transitions << " | cache ";
+
+        auto lookups = last.cache_hits + last.cache_misses;
+        if (lookups > 0) {
+            timing << std::setprecision(1) << 100.0 * last.cache_hits / lookups << "% (" << last.cache_hits << "/" << lookups << ")";
+        } else {
+            timing << "-";
+        }
+
+        usage << " memory | tree " << format_bytes(memory.tree_nodes) << " values " << format_bytes(memory.value_words);
+        usage << " deltas " << format_bytes(memory.time_deltas) << " frames " << format_bytes(last.rendered_frames);
+
+        std::string result;
+        for (auto line : {timing.str(), usage.str()}) {
+            line.resize(m_columns, ' ');
+            result += cmd::add_style<cmd::styles::font::bold, cmd::styles::colors::background::extended<236>, cmd::styles::colors::foreground::extended<214>>(line) + "\n";
+        }
+        return result;
+    }
+
+    void frame_generator::toggle_hud() {
+        m_show_hud = !m_show_hud;
+        set_frame(m_columns, m_rows);
+    }
+
+    void frame_generator::finish_frame(const double compose_us, const double output_us) {
+        m_profiler.current().style_us += compose_us;
+        m_profiler.current().output_us += output_us;
+        m_profiler.finish_frame(m_trace_viewer.cache_hits(), m_trace_viewer.cache_misses(), m_trace_viewer.frame_memory());
+    }
+
+    void frame_generator::set_profiling(const bool enabled) {
+        m_profiler.set_recording(enabled);
+    }
+
+    void frame_generator::write_profile(std::ostream& out) const {
+        m_profiler.write_json(out);
+    }
+
+    std::vector<std::string> frame_generator::signal_names() const {
+        std::vector<std::string> result;
+        result.reserve(m_dir.size());
+        for (size_t i = 0; i < m_dir.size(); i++) {
+            result.push_back(m_dir.node_name(i));
+        }
+        return result;
+    }
+
+    waveform::signal<uint64_t>* frame_generator::find_signal(const std::string& name) {
+        if (auto index = m_dir.find(name)) {
+            return &m_dir.node_data(*index);
+        }
+        return nullptr;
+    }
+
+    void frame_generator::show_signals(const std::vector<std::string>& names) {
+        std::vector<waveform::signal_viewer<uint64_t>::selected_signal> signals;
+        for (const auto& name : names) {
+            if (auto index = m_dir.find(name)) {
+                m_dir.select_node(*index);
+                signals.push_back({*index, m_dir.node_name(*index), &m_dir.node_data(*index)});
+            }
+        }
+
+        m_trace_viewer.add_signals(signals, m_max_transition_time);
+        m_current_view = view::signal_traces;
+    }
+
+    std::optional<bool> frame_generator::update_frame(const char input, const size_t count) {
         if (input == 'q') {
             return std::nullopt;
         }
 
         switch (m_current_view) {
             case view::signal_selection: {
-                if (input == 0x44) {
-                    m_dir.move_up();
-                }
-                if (input == 0x43) {
-                    m_dir.move_down();
-                }
-                if (input == 'j') {
-                    m_dir.move_down();
+                if (input == 0x44 || input == 'k') {
+                    for (size_t i = 0; i < count; i++) {
+                        m_dir.move_up();
+                    }
                 }
-                if (input == 'k') {
-                    m_dir.move_up();
+                if (input == 0x43 || input == 'j') {
+                    for (size_t i = 0; i < count; i++) {
+                        m_dir.move_down();
+                    }
                 }
                 if (input == 0x20) {
                     m_dir.collapse_toogle();
@@ -57,17 +238,42 @@ namespace wavy {
                 if (input == 'b') {
                     m_dir.goto_root();
                 }
+                if (input == 's') {
+                    if (m_dir.ordered()) {
+                        m_dir.set_order({});
+                    } else {
+                        if (m_activity.empty()) {
+                            update_activity(0, m_max_transition_time);
+                        }
+                        sort_by_activity();
+                    }
+                }
                 if (input == 'a') {
+                    std::vector<waveform::signal_viewer<uint64_t>::selected_signal> signals;
                     for (const auto& index : m_dir.select()) {
-                        m_trace_viewer.add_signal(index, m_max_transition_time, m_dir.node_name(index), &m_dir.node_data(index));
+                        signals.push_back({index, m_dir.node_name(index), &m_dir.node_data(index)});
                     }
+                    m_trace_viewer.add_signals(signals, m_max_transition_time);
                 }
                 if (input == 'd') {
-                    for (const auto& index : m_dir.unselect()) {
-                        m_trace_viewer.remove_signal(index);
+                    m_trace_viewer.remove_signals(m_dir.unselect());
+                }
+                if (input == 'i') {
+                    toggle_hud();
+                }
+                if (input == 'n') {
+                    for (size_t i = 0; i < count; i++) {
+                        m_dir.next_match(true);
+                    }
+                }
+                if (input == 'N') {
+                    for (size_t i = 0; i < count; i++) {
+                        m_dir.next_match(false);
                     }
                 }
                 if (input == '/') {
+                    m_dir.begin_search();
+                    m_prompt = input;
                     return true;
                 }
                 if (input == '\t') {
@@ -77,16 +283,16 @@ namespace wavy {
             }
             case view::signal_traces: {
                 if (input == 0x44 || input == 'h') {
-                    m_trace_viewer.move_left();
+                    m_trace_viewer.move_left(count);
                 }
                 if (input == 0x43 || input == 'l') {
-                    m_trace_viewer.move_right();
+                    m_trace_viewer.move_right(count);
                 }
                 if (input == 'j') {
-                    m_trace_viewer.move_down();
+                    m_trace_viewer.move_down(count);
                 }
                 if (input == 'k') {
-                    m_trace_viewer.move_up();
+                    m_trace_viewer.move_up(count);
                 }
                 if (input == 'J') {
                     m_trace_viewer.shift_down();
@@ -95,23 +301,304 @@ namespace wavy {
                     m_trace_viewer.shift_up();
                 }
                 if (input == '+') {
-                    m_trace_viewer.zoom_in();
+                    m_trace_viewer.zoom_in(count);
                 }
                 if (input == '-') {
-                    m_trace_viewer.zoom_out();
+                    m_trace_viewer.zoom_out(count);
+                }
+                if (input == 'w') {
+                    m_trace_viewer.next_transition(count);
+                }
+                if (input == 'b') {
+                    m_trace_viewer.previous_transition(count);
+                }
+                if (input == 'n') {
+                    m_trace_viewer.next_event(count);
+                }
+                if (input == 'N') {
+                    m_trace_viewer.previous_event(count);
+                }
+                if (input == 'i') {
+                    toggle_hud();
+                }
+                if (input == 'v') {
+                    m_trace_viewer.toggle_readout();
+                }
+                if (input == 'a') {
+                    m_trace_viewer.toggle_activity();
+                }
+                if (input == 'm') {
+                    m_trace_viewer.set_marker();
+                }
+                if (input == ']') {
+                    m_trace_viewer.next_marker(count);
+                }
+                if (input == '[') {
+                    m_trace_viewer.previous_marker(count);
+                }
+                if (input == '/') {
+                    m_prompt = input;
+                    return true;
+                }
+                if (input == ':') {
+                    m_prompt = input;
+                    return true;
                 }
                 if (input == '\t') {
                     m_current_view = view::signal_selection; 
                 }
                 break;
             }
+            case view::cycle_table: {
+                if (input == 0x44 || input == 'h') {
+                    m_table.move_left(count);
+                }
+                if (input == 0x43 || input == 'l') {
+                    m_table.move_right(count);
+                }
+                if (input == 'j') {
+                    m_table.move_down(count);
+                }
+                if (input == 'k') {
+                    m_table.move_up(count);
+                }
+                if (input == 'i') {
+                    toggle_hud();
+                }
+                if (input == '\t') {
+                    if (auto time = m_table.cursor_time()) {
+                        m_trace_viewer.goto_time(*time);
+                    } else {
+                        m_trace_viewer.restore_range();
+                    }
+                    m_table.close();
+                    m_current_view = view::signal_traces;
+                }
+                break;
+            }
             default: break;
         }
         
         return false;
     }
 
+    bool frame_generator::repeatable(const char input) const {
+        switch (m_current_view) {
+            case view::signal_selection: return input == 0x43 || input == 0x44 || input == 'j' || input == 'k' || input == 'n' || input == 'N';
+            case view::signal_traces: return input == 0x43 || input == 0x44 || input == 'h' || input == 'l' || input == 'j' || input == 'k' || input == '+' || input == '-' || input == 'w' || input == 'b' || input == 'n' || input == 'N' || input == '[' || input == ']';
+            case view::cycle_table: return input == 0x43 || input == 0x44 || input == 'h' || input == 'l' || input == 'j' || input == 'k';
+            default: return false;
+        }
+    }
+
+    void frame_generator::update_command(const std::string& command) {
+        if (m_prompt == '/' && m_current_view == view::signal_selection) {
+            m_search_hits = m_dir.incremental_search(command);
+        }
+    }
+
     void frame_generator::execute_command(const std::string& command) {
-        m_dir.search_for_node(command);
+        auto prompt = m_prompt;
+        m_prompt = 0;
+        m_search_hits = std::nullopt;
+
+        if (prompt == '/' && m_current_view == view::signal_selection) {
+            if (command.empty()) {
+                m_dir.cancel_search();
+            } else {
+                m_dir.incremental_search(command);
+            }
+            return;
+        }
+
+        if (command.empty()) {
+            return;
+        }
+
+        if (prompt == '/') {
+            m_trace_viewer.find_value(command);
+        }
+        if (prompt == ':') {
+            execute_trace_command(util::split_by_space(command));
+        }
+    }
+
+    void frame_generator::execute_trace_command(const std::vector<std::string>& args) {
+        if (args.empty()) {
+            return;
+        }
+
+        auto parse_time = [&](const std::string& arg) -> std::optional<size_t> {
+            if (auto marker = m_trace_viewer.marker_time(arg)) {
+                return marker;
+            }
+            if (auto time = util::parse_number<size_t>(arg)) {
+                return *time * 1024;
+            }
+            return std::nullopt;
+        };
+
+        if (args[0] == "goto" && args.size() == 2) {
+            if (auto time = parse_time(args[1])) {
+                m_trace_viewer.goto_time(*time);
+            }
+        }
+        if (args[0] == "mark" && args.size() <= 2) {
+            m_trace_viewer.set_marker(args.size() == 2 ? args[1] : "");
+        }
+        if (args[0] == "unmark") {
+            if (args.size() == 1) {
+                m_trace_viewer.clear_markers();
+            } else {
+                for (size_t i = 1; i < args.size(); i++) {
+                    m_trace_viewer.remove_marker(args[i]);
+                }
+            }
+        }
+        if (args[0] == "delta" && args.size() == 3) {
+            m_trace_viewer.measure(args[1], args[2]);
+        }
+        if (args[0] == "define" && args.size() >= 3) {
+            std::string text;
+            for (size_t i = args[2] == "=" ? 3 : 2; i < args.size(); i++) {
+                text += args[i] + " ";
+            }
+
+            auto expression = waveform::signal_expression<uint64_t>::parse(text, [&](const std::string& name) -> std::optional<waveform::signal<uint64_t>*> {
+                if (auto index = m_dir.find(name)) {
+                    return &m_dir.node_data(*index);
+                }
+                return std::nullopt;
+            });
+            if (expression) {
+                m_trace_viewer.add_derived(args[1], std::move(*expression), m_max_transition_time);
+            }
+        }
+        if (args[0] == "undefine" && args.size() == 2) {
+            m_trace_viewer.remove_derived(args[1]);
+        }
+        if (args[0] == "zoom" && args.size() == 2) {
+            if (auto ticks = util::parse_number<double>(args[1])) {
+                m_trace_viewer.set_scale(static_cast<size_t>(std::max(1.0, *ticks * 1024)));
+            }
+        }
+        if (args[0] == "step" && args.size() == 2) {
+            if (auto steps = util::parse_number<long>(args[1])) {
+                if (*steps > 0) {
+                    m_trace_viewer.next_event(*steps);
+                } else if (*steps < 0) {
+                    m_trace_viewer.previous_event(-*steps);
+                }
+            }
+        }
+        if (args[0] == "radix" && args.size() == 2) {
+            if (auto r = waveform::parse_radix(args[1])) {
+                m_trace_viewer.set_radix(*r);
+            }
+        }
+        if (args[0] == "table" && (args.size() == 2 || args.size() == 3)) {
+            open_table(args);
+        }
+        if (args[0] == "export") {
+            if (args.size() == 2) {
+                export_signals(args[1], 0, m_max_transition_time);
+            } else if (args.size() == 4) {
+                auto from = parse_time(args[2]);
+                auto to = parse_time(args[3]);
+                if (from && to) {
+                    export_signals(args[1], std::min(*from, *to) / 1024, std::max(*from, *to) / 1024);
+                }
+            }
+        }
+        if (args[0] == "activity") {
+            if (args.size() == 1) {
+                update_activity(0, m_max_transition_time);
+            } else if (args.size() == 3) {
+                auto from = parse_time(args[1]);
+                auto to = parse_time(args[2]);
+                if (from && to) {
+                    update_activity(std::min(*from, *to) / 1024, std::max(*from, *to) / 1024);
+                }
+            }
+        }
+        if (args[0] == "fit") {
+            if (args.size() == 1) {
+                m_trace_viewer.fit();
+            } else if (args.size() == 3) {
+                auto from = parse_time(args[1]);
+                auto to = parse_time(args[2]);
+                if (from && to && *from != *to) {
+                    m_trace_viewer.fit(std::min(*from, *to), std::max(*from, *to));
+                }
+            }
+        }
+    }
+
+    void frame_generator::open_table(const std::vector<std::string>& args) {
+        auto clock = m_dir.find(args[1]);
+        if (!clock || m_dir.node_data(*clock).width() != 1) {
+            return;
+        }
+
+        auto radix = m_trace_viewer.current_radix();
+        if (args.size() == 3) {
+            if (auto r = waveform::parse_radix(args[2])) {
+                radix = *r;
+            } else {
+                return;
+            }
+        }
+
+        std::vector<waveform::cycle_table<uint64_t>::column> columns;
+        for (const auto& s : m_trace_viewer.displayed_signals()) {
+            columns.push_back({s.name, s.data});
+        }
+
+        m_table.set_prepare([this](const size_t from, const size_t to) {
+            m_trace_viewer.prepare_range(from, to);
+        });
+        m_table.open(&m_dir.node_data(*clock), std::move(columns), m_max_transition_time, m_trace_viewer.cursor_time(), radix);
+        m_current_view = view::cycle_table;
+    }
+
+    void frame_generator::export_signals(const std::string& filename, const size_t from, const size_t to) {
+        std::vector<output::exported_signal<uint64_t>> signals;
+        for (const auto& s : m_trace_viewer.displayed_signals()) {
+            signals.push_back({s.name, s.data});
+        }
+        m_trace_viewer.prepare_range(from * 1024, to * 1024);
+
+        std::ofstream out(filename);
+        if (out.good()) {
+            output::write_vcd(out, signals, from, to, m_timescale);
+        }
+        m_trace_viewer.restore_range();
+    }
+
+    void frame_generator::update_activity(const size_t from, const size_t to) {
+        m_activity.assign(m_dir.size(), {});
+        util::parallel_for(m_dir.size(), [&](const size_t i) {
+            m_activity[i] = m_dir.node_data(i).activity(from, to);
+        });
+
+        std::vector<std::string> annotations;
+        annotations.reserve(m_activity.size());
+        for (const auto& activity : m_activity) {
+            annotations.push_back(format_activity(activity));
+        }
+        m_dir.set_annotations(std::move(annotations));
+
+        if (m_dir.ordered()) {
+            sort_by_activity();
+        }
+    }
+
+    void frame_generator::sort_by_activity() {
+        std::vector<size_t> order(m_activity.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](const size_t l, const size_t r) {
+            return m_activity[l].toggles > m_activity[r].toggles;
+        });
+        m_dir.set_order(std::move(order));
     }
 }
@@ -6,7 +6,10 @@
 #include <sstream>
 #include <stdint.h>
 
+#include "import/bus_assembler.h"
 #include "selection/tree_directory_viewer.h"
+#include "util/profiler.h"
+#include "waveform/cycle_table.h"
 #include "waveform/signal_viewer.h"
 
 namespace wavy {
@@ -20,20 +23,66 @@ namespace wavy {
 
         void add_transition(const size_t index, const std::string& value, const size_t time);
 
+        void set_timescale(const std::string& timescale);
+
         void set_frame(const size_t columns, const size_t rows);
 
         std::string frame() const;
 
-        std::optional<bool> update_frame(const char input);
+        std::optional<bool> update_frame(const char input, const size_t count = 1);
+
+        bool repeatable(const char input) const;
+
+        void update_command(const std::string& command);
 
         void execute_command(const std::string& command);
+
+        void finish_frame(const double compose_us, const double output_us);
+
+        void set_profiling(const bool enabled);
+
+        void write_profile(std::ostream& out) const;
+
+        std::vector<std::string> signal_names() const;
+
+        waveform::signal<uint64_t>* find_signal(const std::string& name);
+
+        void show_signals(const std::vector<std::string>& names);
     private:
-        enum class view {signal_selection, signal_traces};
+        constexpr static size_t hud_rows = 2;
+
+        void execute_trace_command(const std::vector<std::string>& args);
+
+        void open_table(const std::vector<std::string>& args);
+
+        void export_signals(const std::string& filename, const size_t from, const size_t to);
+
+        void create_buses();
+
+        void update_activity(const size_t from, const size_t to);
+
+        void sort_by_activity();
+
+        void toggle_hud();
+
+        std::string hud_frame() const;
+
+        enum class view {signal_selection, signal_traces, cycle_table};
         view m_current_view = view::signal_selection;
+        char m_prompt = 0;
+        std::optional<size_t> m_search_hits;
+        bool m_show_hud = false;
+        size_t m_columns = 0;
+        size_t m_rows = 0;
+        util::profiler m_profiler;
 
         selection::tree_directory_viewer<waveform::signal<uint64_t>> m_dir;
 
         waveform::signal_viewer<uint64_t> m_trace_viewer;
+        waveform::cycle_table<uint64_t> m_table;
         size_t m_max_transition_time = 0;
+        std::string m_timescale;
+        import::bus_assembler<uint64_t> m_buses;
+        std::vector<util::activity> m_activity;
     };
 }
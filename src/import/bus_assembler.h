@@ -0,0 +1,130 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace wavy::import {
+    template<typename T>
+    class bus_assembler {
+    public:
+        constexpr static size_t bit_flag = 1UL << 63;
+        constexpr static size_t max_width = 1 << 16;
+
+        static bool contains(const size_t index) {
+            return (index & bit_flag) != 0;
+        }
+
+        std::optional<size_t> add_bit(const std::string& name) {
+            auto open = name.rfind('[');
+            if (open == std::string::npos || open == 0 || name.back() != ']' || open + 2 == name.length() || open + 8 < name.length()) {
+                return std::nullopt;
+            }
+
+            size_t bit = 0;
+            for (auto i = open + 1; i + 1 < name.length(); i++) {
+                if (name[i] < '0' || name[i] > '9') {
+                    return std::nullopt;
+                }
+                bit = bit * 10 + (name[i] - '0');
+            }
+            if (bit >= max_width) {
+                return std::nullopt;
+            }
+
+            auto base = name.substr(0, open);
+            auto it = m_lookup.find(base);
+            if (it == m_lookup.end() || it->second < m_created || m_buses[it->second].has(bit)) {
+                it = m_lookup.insert_or_assign(base, m_buses.size()).first;
+                m_buses.emplace_back(base, name, bit);
+            }
+
+            auto& bus = m_buses[it->second];
+            bus.lo = std::min(bus.lo, bit);
+            bus.hi = std::max(bus.hi, bit);
+            bus.present.resize(std::max(bus.present.size(), bit + 1));
+            bus.present[bit] = true;
+            bus.bits++;
+
+            m_bits.push_back({it->second, bit});
+            return bit_flag | (m_bits.size() - 1);
+        }
+
+        template<typename F>
+        void create(F add_bus) {
+            for (; m_created < m_buses.size(); m_created++) {
+                auto& bus = m_buses[m_created];
+                auto width = bus.hi - bus.lo + 1;
+                bus.index = add_bus(bus.bits == 1 ? bus.first : bus.lo == 0 ? bus.base : bus.base + "[" + std::to_string(bus.hi) + ":" + std::to_string(bus.lo) + "]", width);
+                bus.current.resize((width + word_bits - 1) / word_bits);
+                bus.present = {};
+            }
+        }
+
+        template<typename F>
+        void add_transition(const size_t index, const std::string& value, const size_t time, F emit) {
+            auto [id, bit] = m_bits[index & ~bit_flag];
+            auto& bus = m_buses[id];
+
+            if (bus.dirty && bus.time != time) {
+                flush(bus, emit);
+            }
+
+            auto offset = bit - bus.lo;
+            auto& word = bus.current[offset / word_bits];
+            T mask = static_cast<T>(1) << (offset % word_bits);
+
+            word = value == "1" ? word | mask : word & ~mask;
+            bus.time = time;
+            bus.dirty = true;
+        }
+
+        template<typename F>
+        void finish(F emit) {
+            for (auto& bus : m_buses) {
+                if (bus.dirty) {
+                    flush(bus, emit);
+                }
+            }
+        }
+    private:
+        constexpr static size_t word_bits = sizeof(T) * 8;
+
+        struct bus {
+            bus(std::string base, std::string first, const size_t bit) : base(std::move(base)), first(std::move(first)), lo(bit), hi(bit) {}
+
+            std::string base;
+            std::string first;
+            size_t lo;
+            size_t hi;
+            size_t bits = 0;
+            std::vector<bool> present;
+
+            size_t index = 0;
+            std::vector<T> current;
+            std::vector<T> last;
+            size_t time = 0;
+            bool dirty = false;
+
+            bool has(const size_t bit) const {
+                return bit < present.size() && present[bit];
+            }
+        };
+
+        template<typename F>
+        void flush(bus& b, F emit) {
+            if (b.last.empty() || b.current != b.last) {
+                emit(b.index, b.current, b.time);
+                b.last = b.current;
+            }
+            b.dirty = false;
+        }
+
+        std::vector<bus> m_buses;
+        std::vector<std::pair<size_t, size_t>> m_bits;
+        std::unordered_map<std::string, size_t> m_lookup;
+        size_t m_created = 0;
+    };
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <fstream>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -59,9 +60,39 @@ namespace wavy::import {
                 m_header_complete = true;
             }
 
+            if (line[0] == "$timescale" || m_in_timescale) {
+                for (size_t i = m_in_timescale ? 0 : 1; i < line.size(); i++) {
+                    if (line[i] == "$end") {
+                        if constexpr (requires { m_sink->set_timescale(m_timescale); }) {
+                            m_sink->set_timescale(m_timescale);
+                        }
+                        m_in_timescale = false;
+                        return;
+                    }
+                    m_timescale += line[i];
+                }
+                m_in_timescale = true;
+                return;
+            }
+
+            if (line.size() >= 3 && line[0] == "$scope") {
+                m_scope += line[2] + ".";
+                m_scope_lengths.push_back(line[2].length() + 1);
+            }
+            if (line[0] == "$upscope" && !m_scope_lengths.empty()) {
+                m_scope.resize(m_scope.length() - m_scope_lengths.back());
+                m_scope_lengths.pop_back();
+            }
+
             if (line.size() >= 6 && line[0] == "$var" && line[1] == "wire") {
-                auto index = m_sink->add_signal(line[4], std::stoll(line[2]));
-                m_signal_names[line[3]] = {index, line[4]};
+                auto width = std::stoll(line[2]);
+                auto name = line[4].starts_with(m_scope) ? line[4] : m_scope + line[4];
+                if (width == 1 && line.size() >= 7 && line[5].starts_with('[') && line[5].find(':') == std::string::npos) {
+                    name += line[5];
+                }
+
+                auto index = m_sink->add_signal(name, width);
+                m_signal_names[line[3]] = {index, name};
             }
         }
 
@@ -71,7 +102,7 @@ namespace wavy::import {
                     m_current_time = std::stoll(line[0].substr(1));
                     return;
                 }
-                if (line[0].at(0) == 'b') {
+                if (line[0].at(0) == 'b' && line.size() >= 2) {
                     auto val = line[0].substr(1);
                     const auto& [index, name] = m_signal_names[line[1]];
                     m_sink->add_transition(index, val, m_current_time);
@@ -94,9 +125,33 @@ namespace wavy::import {
         }
 
         bool m_header_complete = false;
+        bool m_in_timescale = false;
         size_t m_current_time = 0;
 
+        std::string m_scope;
+        std::vector<size_t> m_scope_lengths;
+        std::string m_timescale;
+
         std::unordered_map<std::string, std::pair<size_t, std::string>> m_signal_names;
         T* m_sink = nullptr;
     };
+
+    template<typename T>
+    bool parse_file(const std::string& filename, T& sink) {
+        std::ifstream infile(filename);
+
+        if (!infile.good()) {
+            return false;
+        }
+
+        vcd_parser<T> parser;
+        parser.set_sink(sink);
+
+        std::string line;
+        while (std::getline(infile, line)) {
+            parser.parse_line(line);
+        }
+
+        return true;
+    }
 }
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "exported_signal.h"
+
+#include "util/json.h"
+#include "util/parallel_for.h"
+#include "waveform/value_format.h"
+
+namespace wavy::output {
+    namespace detail {
+        constexpr size_t chunk_size = 1 << 16;
+
+        template<typename T, typename F>
+        void for_each_change(const waveform::signal<T>& data, const size_t from, const size_t to, F f) {
+            auto pos = data.position();
+            pos.seek(from * 1024);
+
+            auto value = pos.words();
+            f(from, value);
+
+            while (pos.move_right() && pos.time() <= to * 1024) {
+                if (pos.words() != value) {
+                    value = pos.words();
+                    f(pos.time() / 1024, value);
+                }
+            }
+        }
+
+        inline std::string column_file(const size_t index, const std::string& column) {
+            return std::to_string(index) + "." + column + ".u64";
+        }
+    }
+
+    template<typename T>
+    bool write_columns(const std::filesystem::path& directory, const std::vector<exported_signal<T>>& signals, const size_t from, const size_t to, const std::string& timescale) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            return false;
+        }
+
+        std::vector<size_t> counts(signals.size());
+        std::vector<char> written(signals.size());
+
+        util::parallel_for(signals.size(), [&](const size_t i) {
+            auto words = std::max<size_t>(1, (signals[i].data->width() + 63) / 64);
+            std::ofstream time_file(directory / detail::column_file(i, "times"), std::ios::binary);
+            std::ofstream value_file(directory / detail::column_file(i, "values"), std::ios::binary);
+            std::vector<uint64_t> times;
+            std::vector<uint64_t> values;
+
+            auto flush = [&]() {
+                time_file.write(reinterpret_cast<const char*>(times.data()), times.size() * sizeof(uint64_t));
+                value_file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(uint64_t));
+                counts[i] += times.size();
+                times.clear();
+                values.clear();
+            };
+
+            detail::for_each_change(*signals[i].data, from, to, [&](const size_t time, const std::vector<T>& value) {
+                times.push_back(time);
+                for (size_t w = 0; w < words; w++) {
+                    uint64_t word = 0;
+                    for (size_t part = 0; part < sizeof(uint64_t) / sizeof(T); part++) {
+                        auto index = w * (sizeof(uint64_t) / sizeof(T)) + part;
+                        if (index < value.size()) {
+                            word |= static_cast<uint64_t>(value[index]) << (part * sizeof(T) * 8);
+                        }
+                    }
+                    values.push_back(word);
+                }
+
+                if (times.size() == detail::chunk_size) {
+                    flush();
+                }
+            });
+            flush();
+
+            written[i] = time_file.good() && value_file.good();
+        });
+
+        std::ofstream manifest(directory / "manifest.json");
+        manifest << "{\n  \"timescale\": \"" << util::escape_json(timescale) << "\",\n  \"from\": " << from << ",\n  \"to\": " << to << ",\n  \"signals\": [\n";
+        for (size_t i = 0; i < signals.size(); i++) {
+            auto words = std::max<size_t>(1, (signals[i].data->width() + 63) / 64);
+
+            manifest << "    {\"id\": " << i << ", \"name\": \"" << util::escape_json(signals[i].name) << "\", \"width\": " << signals[i].data->width();
+            manifest << ", \"words\": " << words << ", \"count\": " << counts[i];
+            manifest << ", \"times\": \"" << detail::column_file(i, "times") << "\", \"values\": \"" << detail::column_file(i, "values") << "\"}";
+            manifest << (i + 1 < signals.size() ? ",\n" : "\n");
+        }
+        manifest << "  ]\n}\n";
+
+        return manifest.good() && std::find(written.begin(), written.end(), 0) == written.end();
+    }
+
+    template<typename T>
+    void write_transitions_csv(std::ostream& out, const std::vector<exported_signal<T>>& signals, const size_t from, const size_t to, const waveform::radix r) {
+        out << "time,signal,value\n";
+
+        // signals are formatted in parallel, one batch at a time, so only the text of a batch is held in memory
+        size_t batch = std::max(1U, std::thread::hardware_concurrency());
+        std::vector<std::string> chunks(batch);
+
+        for (size_t first = 0; first < signals.size(); first += batch) {
+            auto n = std::min(batch, signals.size() - first);
+
+            util::parallel_for(n, [&](const size_t j) {
+                const auto& s = signals[first + j];
+                auto name = s.name;
+                if (name.find_first_of(",\"") != std::string::npos) {
+                    std::string quoted = "\"";
+                    for (const auto c : name) {
+                        quoted += c == '"' ? std::string("\"\"") : std::string(1, c);
+                    }
+                    name = quoted + "\"";
+                }
+
+                auto prefix = "," + name + ",";
+                detail::for_each_change(*s.data, from, to, [&](const size_t time, const std::vector<T>& value) {
+                    chunks[j] += std::to_string(time) + prefix + waveform::format_value(value, s.data->width(), r) + "\n";
+                });
+            });
+
+            for (size_t j = 0; j < n; j++) {
+                out << chunks[j];
+                chunks[j].clear();
+                chunks[j].shrink_to_fit();
+            }
+        }
+    }
+}
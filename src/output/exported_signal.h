@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+#include "waveform/signal.h"
+
+namespace wavy::output {
+    template<typename T>
+    struct exported_signal {
+        std::string name;
+        const waveform::signal<T>* data;
+    };
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "style.h"
+
+#include "util/parallel_for.h"
+#include "waveform/signal_store.h"
+
+namespace wavy::output {
+    struct snapshot {
+        size_t from;
+        size_t to;
+        size_t data_end_column;
+        std::vector<std::string> names;
+        std::vector<size_t> widths;
+        std::vector<std::string> rows;
+    };
+
+    template<typename T>
+    snapshot render_snapshot(const waveform::signal_store<T>& store, const std::vector<size_t>& indices, const size_t from, const size_t to, const size_t columns) {
+        snapshot result;
+        result.from = from;
+        result.to = to;
+        result.rows.resize(indices.size());
+
+        auto scale = std::max<size_t>(1, ((to - from) * 1024 + columns - 1) / columns);
+        auto first_column = from * 1024 / scale;
+        auto data_end = (store.max_time() + 1) * 1024;
+        result.data_end_column = std::min(columns, (data_end + scale - 1) / scale - std::min((data_end + scale - 1) / scale, first_column));
+
+        for (const auto index : indices) {
+            result.names.push_back(store.name(index));
+            result.widths.push_back(store.data(index).width());
+        }
+
+        std::vector<size_t> unique(indices);
+        std::sort(unique.begin(), unique.end());
+        unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+        std::vector<std::string> rows(unique.size());
+
+        util::parallel_for(unique.size(), [&](const size_t i) {
+            auto wave = store.data(unique[i]).detached_wave();
+
+            wave.set_view(scale, first_column);
+            wave.set_frame(columns);
+            rows[i] = wave.frame();
+        });
+
+        for (size_t i = 0; i < indices.size(); i++) {
+            result.rows[i] = rows[std::lower_bound(unique.begin(), unique.end(), indices[i]) - unique.begin()];
+        }
+
+        return result;
+    }
+
+    namespace detail {
+        inline std::string replace_bit_symbols(const std::string& s) {
+            std::string result;
+            result.reserve(s.length());
+            for (const auto c : s) {
+                if (c != '#') {
+                    result += c;
+                } else {
+                    result += "‾";
+                }
+            }
+
+            return result;
+        }
+
+        inline size_t max_name_length(const snapshot& shot) {
+            size_t result = 0;
+            for (const auto& name : shot.names) {
+                result = std::max(result, name.length());
+            }
+            return result;
+        }
+
+        inline std::string escape_xml(const std::string& s) {
+            std::string result;
+            for (const auto c : s) {
+                switch (c) {
+                    case '<': result += "&lt;"; break;
+                    case '>': result += "&gt;"; break;
+                    case '&': result += "&amp;"; break;
+                    case '"': result += "&quot;"; break;
+                    default: result += c; break;
+                }
+            }
+            return result;
+        }
+    }
+
+    inline void write_txt(std::ostream& out, const snapshot& shot) {
+        auto name_length = detail::max_name_length(shot);
+
+        out << std::string(name_length, ' ') << " " << shot.from << " - " << shot.to << "\n";
+        for (size_t i = 0; i < shot.rows.size(); i++) {
+            out << std::string(name_length - shot.names[i].length(), ' ') << shot.names[i] << " " << detail::replace_bit_symbols(shot.rows[i]) << "\n";
+        }
+    }
+
+    inline void write_ansi(std::ostream& out, const snapshot& shot) {
+        auto name_length = detail::max_name_length(shot);
+
+        out << cmd::add_style<cmd::styles::font::bold>(std::string(name_length, ' ') + " " + std::to_string(shot.from) + " - " + std::to_string(shot.to)) << "\n";
+        for (size_t i = 0; i < shot.rows.size(); i++) {
+            auto line = std::string(name_length - shot.names[i].length(), ' ') + shot.names[i] + " " + shot.rows[i];
+            line = detail::replace_bit_symbols(line);
+
+            if ((i % 2) > 0) {
+                out << cmd::add_style<cmd::styles::colors::background::extended<240>>(line) << "\n";
+            } else {
+                out << cmd::add_style<cmd::styles::colors::background::extended<241>>(line) << "\n";
+            }
+        }
+    }
+
+    inline void write_svg(std::ostream& out, const snapshot& shot) {
+        constexpr size_t column_width = 8;
+        constexpr size_t row_height = 24;
+        constexpr size_t header_height = 24;
+
+        auto name_width = detail::max_name_length(shot) * 8 + 16;
+        auto columns = shot.rows.empty() ? 0 : shot.rows[0].length();
+        auto width = name_width + columns * column_width;
+        auto height = header_height + shot.rows.size() * row_height;
+
+        out << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width << "\" height=\"" << height << "\" font-family=\"monospace\" font-size=\"12\">\n";
+        out << "<rect width=\"100%\" height=\"100%\" fill=\"#303030\"/>\n";
+        out << "<text x=\"" << name_width << "\" y=\"16\" fill=\"#ffffff\">" << shot.from << "</text>\n";
+        out << "<text x=\"" << width - 4 << "\" y=\"16\" fill=\"#ffffff\" text-anchor=\"end\">" << shot.to << "</text>\n";
+
+        for (size_t i = 0; i < shot.rows.size(); i++) {
+            const auto& row = shot.rows[i];
+            auto top = header_height + i * row_height + 4;
+            auto bottom = header_height + (i + 1) * row_height - 4;
+            std::string path;
+
+            auto line = [&](const size_t x0, const size_t y0, const size_t x1, const size_t y1) {
+                path += "M" + std::to_string(x0) + " " + std::to_string(y0) + "L" + std::to_string(x1) + " " + std::to_string(y1);
+            };
+
+            out << "<text x=\"" << name_width - 8 << "\" y=\"" << bottom - 2 << "\" fill=\"#ffffff\" text-anchor=\"end\">" << detail::escape_xml(shot.names[i]) << "</text>\n";
+
+            for (size_t c = 0; c < row.length(); c++) {
+                auto x = name_width + c * column_width;
+                auto next = x + column_width;
+
+                if (shot.widths[i] == 1) {
+                    switch (row[c]) {
+                        case '_': line(x, bottom, next, bottom); break;
+                        case '#': line(x, top, next, top); break;
+                        case '/': line(x, bottom, x, top); line(x, top, next, top); break;
+                        case '\\': line(x, top, x, bottom); line(x, bottom, next, bottom); break;
+                        case '|': line(x, top, x, bottom); break;
+                        default: break;
+                    }
+                } else {
+                    if (c < shot.data_end_column) {
+                        line(x, top, next, top);
+                        line(x, bottom, next, bottom);
+                    }
+                    if (row[c] == '|') {
+                        line(x, top, x, bottom);
+                    }
+                }
+            }
+
+            out << "<path d=\"" << path << "\" stroke=\"#7fdfff\" fill=\"none\"/>\n";
+
+            if (shot.widths[i] > 1) {
+                for (size_t c = 0; c < row.length();) {
+                    if (row[c] == ' ' || row[c] == '|') {
+                        c++;
+                        continue;
+                    }
+
+                    auto start = c;
+                    while (c < row.length() && row[c] != ' ' && row[c] != '|') {
+                        c++;
+                    }
+                    auto text = row.substr(start, c - start);
+
+                    out << "<text x=\"" << name_width + start * column_width << "\" y=\"" << bottom - 3 << "\" fill=\"#ffffff\" textLength=\"" << text.length() * column_width << "\">" << detail::escape_xml(text) << "</text>\n";
+                }
+            }
+        }
+
+        out << "</svg>\n";
+    }
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <ostream>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "exported_signal.h"
+
+namespace wavy::output {
+    namespace detail {
+        inline std::string vcd_identifier(size_t n) {
+            std::string result;
+            do {
+                result += static_cast<char>('!' + n % 94);
+                n /= 94;
+            } while (n > 0);
+            return result;
+        }
+
+        inline std::vector<std::string> split_path(const std::string& name) {
+            std::vector<std::string> result;
+            size_t start = 0;
+            for (auto dot = name.find('.'); dot != std::string::npos; dot = name.find('.', start)) {
+                result.push_back(name.substr(start, dot - start));
+                start = dot + 1;
+            }
+            result.push_back(name.substr(start));
+            return result;
+        }
+
+        template<typename T>
+        void append_value(std::string& out, const std::vector<T>& words, const size_t width, const std::string& id) {
+            constexpr size_t bits = sizeof(T) * 8;
+
+            if (width == 1) {
+                out += !words.empty() && (words[0] & 1) != 0 ? '1' : '0';
+            } else {
+                out += 'b';
+                auto started = false;
+                for (auto bit = width; bit > 0; bit--) {
+                    auto word = (bit - 1) / bits;
+                    auto set = word < words.size() && ((words[word] >> ((bit - 1) % bits)) & 1) != 0;
+                    if (set || started || bit == 1) {
+                        out += set ? '1' : '0';
+                        started = true;
+                    }
+                }
+                out += ' ';
+            }
+            out += id;
+            out += '\n';
+        }
+    }
+
+    template<typename T>
+    void write_vcd(std::ostream& out, const std::vector<exported_signal<T>>& signals, const size_t from, const size_t to, const std::string& timescale) {
+        constexpr size_t flush_size = 1 << 20;
+
+        std::vector<size_t> order(signals.size());
+        std::vector<std::vector<std::string>> paths;
+        for (size_t i = 0; i < signals.size(); i++) {
+            order[i] = i;
+            paths.push_back(detail::split_path(signals[i].name));
+        }
+        std::stable_sort(order.begin(), order.end(), [&](const size_t l, const size_t r) {
+            return std::lexicographical_compare(paths[l].begin(), paths[l].end() - 1, paths[r].begin(), paths[r].end() - 1);
+        });
+
+        std::string buffer;
+        if (!timescale.empty()) {
+            buffer += "$timescale " + timescale + " $end\n";
+        }
+
+        std::vector<std::string> current;
+        for (const auto i : order) {
+            std::vector<std::string> scope(paths[i].begin(), paths[i].end() - 1);
+
+            size_t common = 0;
+            while (common < current.size() && common < scope.size() && current[common] == scope[common]) {
+                common++;
+            }
+            for (auto s = current.size(); s > common; s--) {
+                buffer += "$upscope $end\n";
+            }
+            for (auto s = common; s < scope.size(); s++) {
+                buffer += "$scope module " + scope[s] + " $end\n";
+            }
+            current = scope;
+
+            auto width = signals[i].data->width();
+            buffer += "$var wire " + std::to_string(width) + " " + detail::vcd_identifier(i) + " " + paths[i].back();
+            buffer += width > 1 ? " [" + std::to_string(width - 1) + ":0] $end\n" : " $end\n";
+        }
+        for (size_t s = 0; s < current.size(); s++) {
+            buffer += "$upscope $end\n";
+        }
+        buffer += "$enddefinitions $end\n";
+
+        using entry = std::pair<size_t, size_t>;
+        std::priority_queue<entry, std::vector<entry>, std::greater<entry>> pending;
+        std::vector<waveform::wave_position<T>> positions;
+        std::vector<std::string> ids;
+
+        buffer += "#" + std::to_string(from) + "\n$dumpvars\n";
+        for (size_t i = 0; i < signals.size(); i++) {
+            positions.push_back(signals[i].data->position());
+            positions.back().seek(from * 1024);
+            ids.push_back(detail::vcd_identifier(i));
+
+            detail::append_value(buffer, positions.back().words(), signals[i].data->width(), ids.back());
+            pending.push({0, i});
+        }
+        buffer += "$end\n";
+
+        auto last = from * 1024;
+        while (!pending.empty()) {
+            auto i = pending.top().second;
+            pending.pop();
+
+            auto& pos = positions[i];
+            auto value = pos.words();
+            if (pos.time() > last) {
+                if (buffer.size() >= flush_size) {
+                    out << buffer;
+                    buffer.clear();
+                }
+                last = pos.time();
+                buffer += "#" + std::to_string(last / 1024) + "\n";
+            }
+            if (pos.time() > from * 1024) {
+                detail::append_value(buffer, value, signals[i].data->width(), ids[i]);
+            }
+
+            while (pos.move_right() && pos.time() <= to * 1024) {
+                if (pos.words() != value) {
+                    pending.push({pos.time(), i});
+                    break;
+                }
+            }
+        }
+
+        if (last < to * 1024) {
+            buffer += "#" + std::to_string(to) + "\n";
+        }
+        out << buffer;
+    }
+}
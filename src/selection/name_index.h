@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wavy::selection {
+    class name_index {
+    public:
+        constexpr static size_t block_size = 16;
+
+        void add(const std::string& name) {
+            if (m_size % block_size == 0) {
+                flush_block();
+                m_blocks.push_back(m_names.size());
+                m_previous.clear();
+            }
+
+            size_t common = 0;
+            while (common < m_previous.length() && common < name.length() && m_previous[common] == name[common]) {
+                common++;
+            }
+
+            write_varint(m_names, common);
+            write_varint(m_names, name.length() - common);
+            m_names.append(name, common);
+            m_previous = name;
+
+            for (auto i = common - std::min<size_t>(common, 2); i + 3 <= name.length(); i++) {
+                m_block_grams.push_back(gram(name, i));
+            }
+            m_size++;
+        }
+
+        void finalize() {
+            flush_block();
+
+            for (auto& [g, blocks] : m_building) {
+                auto& p = m_postings[g];
+                p.offset = m_posting_data.size();
+                p.count = blocks.size();
+
+                uint32_t last = 0;
+                for (const auto block : blocks) {
+                    write_varint(m_posting_data, block - last);
+                    last = block;
+                }
+            }
+
+            m_building = {};
+            m_previous = {};
+            m_names.shrink_to_fit();
+            m_posting_data.shrink_to_fit();
+        }
+
+        size_t size() const {
+            return m_size;
+        }
+
+        std::string name(const size_t id) const {
+            std::string result;
+            auto pos = m_blocks[id / block_size];
+
+            for (auto i = id - id % block_size; i <= id; i++) {
+                pos = decode(pos, result);
+            }
+            return result;
+        }
+
+        std::vector<size_t> search(const std::string& pattern) const {
+            if (pattern.starts_with("~")) {
+                auto query = pattern.substr(1);
+                return scan(all_blocks(), [&](const std::string& name) {
+                    return fuzzy_match(name, query);
+                });
+            }
+
+            if (pattern.find_first_of("*?") != std::string::npos) {
+                std::vector<std::string> literals;
+                std::string current;
+                for (const auto c : pattern) {
+                    if (c == '*' || c == '?') {
+                        literals.push_back(current);
+                        current.clear();
+                    } else {
+                        current += c;
+                    }
+                }
+                literals.push_back(current);
+
+                return scan(candidate_blocks(literals), [&](const std::string& name) {
+                    return glob_match(name, pattern);
+                });
+            }
+
+            return scan(candidate_blocks({pattern}), [&](const std::string& name) {
+                return name.find(pattern) != std::string::npos;
+            });
+        }
+
+        size_t memory_usage() const {
+            return m_names.capacity() + m_blocks.capacity() * sizeof(size_t) + m_posting_data.capacity() + m_postings.size() * (sizeof(uint32_t) + sizeof(posting));
+        }
+    private:
+        struct posting {
+            size_t offset;
+            size_t count;
+        };
+
+        static uint32_t gram(const std::string& s, const size_t i) {
+            return static_cast<uint8_t>(s[i]) | (static_cast<uint8_t>(s[i + 1]) << 8) | (static_cast<uint8_t>(s[i + 2]) << 16);
+        }
+
+        static void write_varint(std::string& out, size_t value) {
+            while (value >= 0x80) {
+                out += static_cast<char>((value & 0x7f) | 0x80);
+                value >>= 7;
+            }
+            out += static_cast<char>(value);
+        }
+
+        static size_t read_varint(const std::string& in, size_t& pos) {
+            size_t result = 0;
+            size_t shift = 0;
+            while (true) {
+                auto byte = static_cast<uint8_t>(in[pos++]);
+                result |= static_cast<size_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) {
+                    return result;
+                }
+                shift += 7;
+            }
+        }
+
+        size_t decode(size_t pos, std::string& name) const {
+            auto common = read_varint(m_names, pos);
+            auto length = read_varint(m_names, pos);
+
+            name.resize(common);
+            name.append(m_names, pos, length);
+            return pos + length;
+        }
+
+        void flush_block() {
+            if (m_block_grams.empty()) {
+                return;
+            }
+
+            std::sort(m_block_grams.begin(), m_block_grams.end());
+            m_block_grams.erase(std::unique(m_block_grams.begin(), m_block_grams.end()), m_block_grams.end());
+
+            for (const auto g : m_block_grams) {
+                m_building[g].push_back(m_blocks.size() - 1);
+            }
+            m_block_grams.clear();
+        }
+
+        std::vector<uint32_t> all_blocks() const {
+            std::vector<uint32_t> result(m_blocks.size());
+            for (size_t i = 0; i < result.size(); i++) {
+                result[i] = i;
+            }
+            return result;
+        }
+
+        std::vector<uint32_t> blocks_with(const uint32_t g) const {
+            std::vector<uint32_t> result;
+
+            if (auto it = m_postings.find(g); it != m_postings.end()) {
+                auto pos = it->second.offset;
+                uint32_t block = 0;
+
+                result.reserve(it->second.count);
+                for (size_t i = 0; i < it->second.count; i++) {
+                    block += read_varint(m_posting_data, pos);
+                    result.push_back(block);
+                }
+            }
+
+            return result;
+        }
+
+        std::vector<uint32_t> candidate_blocks(const std::vector<std::string>& literals) const {
+            std::vector<uint32_t> grams;
+            for (const auto& literal : literals) {
+                for (size_t i = 0; i + 3 <= literal.length(); i++) {
+                    grams.push_back(gram(literal, i));
+                }
+            }
+
+            if (grams.empty()) {
+                return all_blocks();
+            }
+
+            std::sort(grams.begin(), grams.end());
+            grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+            std::vector<std::vector<uint32_t>> lists;
+            for (const auto g : grams) {
+                lists.push_back(blocks_with(g));
+                if (lists.back().empty()) {
+                    return {};
+                }
+            }
+            std::sort(lists.begin(), lists.end(), [](const auto& l, const auto& r) {
+                return l.size() < r.size();
+            });
+
+            auto result = lists[0];
+            for (size_t i = 1; i < lists.size() && !result.empty(); i++) {
+                std::vector<uint32_t> intersection;
+                std::set_intersection(result.begin(), result.end(), lists[i].begin(), lists[i].end(), std::back_inserter(intersection));
+                result = std::move(intersection);
+            }
+
+            return result;
+        }
+
+        template<typename F>
+        std::vector<size_t> scan(const std::vector<uint32_t>& blocks, F matches) const {
+            std::vector<size_t> result;
+            std::string name;
+
+            for (const auto block : blocks) {
+                auto pos = m_blocks[block];
+                auto end = std::min(m_size, (block + 1) * block_size);
+
+                for (auto id = block * block_size; id < end; id++) {
+                    pos = decode(pos, name);
+                    if (matches(name)) {
+                        result.push_back(id);
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        static bool fuzzy_match(const std::string& name, const std::string& query) {
+            size_t i = 0;
+            for (const auto c : name) {
+                if (i < query.length() && c == query[i]) {
+                    i++;
+                }
+            }
+            return i == query.length();
+        }
+
+        static bool glob_match(const std::string& name, const std::string& pattern) {
+            size_t n = 0;
+            size_t p = 0;
+            size_t star = std::string::npos;
+            size_t resume = 0;
+
+            while (n < name.length()) {
+                if (p < pattern.length() && (pattern[p] == '?' || pattern[p] == name[n])) {
+                    n++;
+                    p++;
+                } else if (p < pattern.length() && pattern[p] == '*') {
+                    star = p++;
+                    resume = n;
+                } else if (star != std::string::npos) {
+                    p = star + 1;
+                    n = ++resume;
+                } else {
+                    return false;
+                }
+            }
+            while (p < pattern.length() && pattern[p] == '*') {
+                p++;
+            }
+
+            return p == pattern.length();
+        }
+
+        std::string m_names;
+        std::vector<size_t> m_blocks;
+        size_t m_size = 0;
+
+        std::string m_posting_data;
+        std::unordered_map<uint32_t, posting> m_postings;
+
+        std::string m_previous;
+        std::vector<uint32_t> m_block_grams;
+        std::unordered_map<uint32_t, std::vector<uint32_t>> m_building;
+    };
+}
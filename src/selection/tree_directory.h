@@ -1,9 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <unordered_map>
 #include <memory>
 #include <optional>
 
+#include "name_index.h"
+
 namespace wavy::selection {
     template<typename T>
     class tree_directory {
@@ -17,7 +20,6 @@ namespace wavy::selection {
 
             T data;
 
-            bool hidden = false;
             bool collapsed = false;
             bool selected = false;
         };
@@ -34,10 +36,15 @@ namespace wavy::selection {
                 std::vector<size_t> node_stack;
                 treeify(0, m_nodes.size(), 0);
 
+                m_names = {};
+                for (const auto& node : m_nodes) {
+                    m_names.add(node.name);
+                }
+                m_names.finalize();
+
                 for (auto& node : m_nodes) {
                     node.name = node.name.substr(node.level);
                     node.collapsed = true;
-                    node.hidden = (node.root != 0);
                 }
 
                 return true;
@@ -64,16 +71,13 @@ namespace wavy::selection {
         }
 
         size_t move_down(const size_t n) const {
-            if (n >= m_nodes.size() - 1) {
+            if (n >= m_nodes.size()) {
                 return n + 1;
-            } else {
-                for (auto i = n + 1; i < m_nodes.size(); i++) {
-                    if (!m_nodes[i].hidden) {
-                        return i;
-                    }
-                }
-                return m_nodes.size();
             }
+            if (m_nodes[n].collapsed && m_nodes[n].skip > 0) {
+                return n + m_nodes[n].skip;
+            }
+            return n + 1;
         }
 
         size_t move_up(const size_t n) const {
@@ -81,32 +85,82 @@ namespace wavy::selection {
                 return n - 1;
             } else if (n <= 1) {
                 return 0;
-            } else {
-                for (auto i = n - 1; i > 0; i--) {
-                    if (!m_nodes[i].hidden) {
-                        return i;
-                    }
+            }
+
+            auto result = n - 1;
+            auto current = result;
+            while (m_nodes[current].root > 0) {
+                current -= m_nodes[current].root;
+                if (m_nodes[current].collapsed) {
+                    result = current;
                 }
-                return 0;
             }
+            return result;
         }
 
-        std::optional<size_t> search_for_node(const std::string& filter, const size_t n) const {
-            for (auto current = n + 1; current < m_nodes.size(); current++) {
-                auto full_name = path_name(current).second + m_nodes[current].name;
-                if (filter_matches(full_name, filter)) {
-                    return current;
-                }
+        void reveal(const size_t n) {
+            if (n >= m_nodes.size()) {
+                return;
             }
-            for (auto current = 0; current < std::min(m_nodes.size(), n - 1); current++) {
-                auto full_name = path_name(current).second + m_nodes[current].name;
-                if (filter_matches(full_name, filter)) {
-                    return current;
+
+            auto current = n;
+            while (m_nodes[current].root > 0) {
+                current -= m_nodes[current].root;
+                m_nodes[current].collapsed = false;
+            }
+        }
+
+        std::vector<size_t> search(const std::string& filter) const {
+            return m_names.search(filter);
+        }
+
+        std::optional<size_t> find(const std::string& name) const {
+            std::optional<size_t> result;
+            size_t suffix_matches = 0;
+
+            for (const auto id : m_names.search(name)) {
+                auto full_name = m_names.name(id);
+                if (full_name == name) {
+                    return id;
+                }
+                if (full_name.ends_with("." + name)) {
+                    result = id;
+                    suffix_matches++;
                 }
             }
+
+            if (suffix_matches == 1) {
+                return result;
+            }
             return std::nullopt;
         }
 
+        static std::optional<size_t> next_match(const std::vector<size_t>& matches, const size_t n, const bool forward) {
+            if (matches.empty()) {
+                return std::nullopt;
+            }
+
+            if (forward) {
+                auto it = std::upper_bound(matches.begin(), matches.end(), n);
+                return it != matches.end() ? *it : matches.front();
+            } else {
+                auto it = std::lower_bound(matches.begin(), matches.end(), n);
+                return it != matches.begin() ? *std::prev(it) : matches.back();
+            }
+        }
+
+        size_t size() const {
+            return m_nodes.size();
+        }
+
+        size_t memory_usage() const {
+            auto result = m_nodes.capacity() * sizeof(node) + m_names.memory_usage();
+            for (const auto& node : m_nodes) {
+                result += node.name.capacity();
+            }
+            return result;
+        }
+
         std::optional<const node*> get_node(const size_t n) const {
             if (n < m_nodes.size()) {
                 return &(m_nodes[n]);
@@ -128,7 +182,7 @@ namespace wavy::selection {
             return 0;
         }
 
-        std::vector<size_t> select(const size_t node, const bool selected) {
+        std::vector<size_t> select(const size_t node, const bool selected, const bool subtree = true) {
             std::vector<size_t> affected;
 
             size_t end = std::min(node + m_nodes[node].skip, m_nodes.size());
@@ -139,7 +193,7 @@ namespace wavy::selection {
             }
             m_nodes[node].selected = selected;
 
-            if (m_nodes[node].collapsed)  {
+            if (subtree && m_nodes[node].collapsed)  {
                 while (current < end) {
                     if (m_nodes[current].selected != selected) {
                         affected.push_back(current);
@@ -154,26 +208,7 @@ namespace wavy::selection {
         }
 
         void collapse_toogle(const size_t node) {
-            size_t end = std::min(node + m_nodes[node].skip, m_nodes.size());
-            bool new_hidden;
-            auto current = node + 1;
-
-            if (m_nodes[node].collapsed) {
-                new_hidden = false;
-                m_nodes[node].collapsed = false;
-            } else {
-                new_hidden = true;
-                m_nodes[node].collapsed = true;
-            }
-            
-            while (current < end) {
-                m_nodes[current].hidden = new_hidden;
-               if (m_nodes[current].collapsed)  {
-                   current += std::max(m_nodes[current].skip, 1);
-               } else {
-                   current++;
-               }
-            }
+            m_nodes[node].collapsed = !m_nodes[node].collapsed;
         }
     private:
         bool sort_and_check_unique_constraint() {
@@ -245,10 +280,7 @@ namespace wavy::selection {
             }
         }
 
-        bool filter_matches(const std::string& name, const std::string& filter) const {
-            return name.find(filter) != std::string::npos;
-        }
-
         std::vector<node> m_nodes;
+        name_index m_names;
     };
 }
@@ -23,53 +23,92 @@ namespace wavy::selection {
             return (*m_tree.get_node(index))->data;
         }
 
+        size_t size() const {
+            return m_tree.size();
+        }
+
+        std::optional<size_t> find(const std::string& name) const {
+            return m_tree.find(name);
+        }
+
+        size_t memory_usage() const {
+            auto result = m_tree.memory_usage() + m_display_nodes.capacity() * sizeof(m_display_nodes[0]);
+            result += (m_order.capacity() + m_rank.capacity()) * sizeof(size_t);
+            for (const auto& annotation : m_annotations) {
+                result += sizeof(annotation) + annotation.capacity();
+            }
+            return result;
+        }
+
+        void set_annotations(std::vector<std::string> annotations) {
+            m_annotations = std::move(annotations);
+        }
+
+        void set_order(std::vector<size_t> order) {
+            auto id = m_display_nodes[m_cursor_line].id;
+
+            m_order = std::move(order);
+            m_rank.assign(m_order.empty() ? 0 : m_tree.size(), 0);
+            for (size_t i = 0; i < m_order.size(); i++) {
+                m_rank[m_order[i]] = i;
+            }
+
+            if (id >= m_tree.size()) {
+                id = m_order.empty() ? 0 : m_order.front();
+            }
+            if (m_order.empty()) {
+                m_tree.reveal(id);
+            }
+            set_frame_from(m_columns, m_display_nodes.size(), id);
+            m_cursor_line = 0;
+        }
+
+        bool ordered() const {
+            return !m_order.empty();
+        }
+
         void set_frame(const size_t columns, const size_t rows) {
             m_display_nodes.resize(rows);
-            set_frame_from(columns, rows, m_display_nodes.begin()->first);
+            set_frame_from(columns, rows, m_display_nodes.begin()->id);
         }
 
         void set_frame_from(const size_t columns, const size_t rows, const size_t node) {
             m_columns = columns;
             m_display_nodes.resize(rows);
-            auto current = node;
-
-            for (int i = 0; i < rows; i++) {
-                if (auto node = m_tree.get_node(current)) {
-                    m_display_nodes[i] = {current, *node};
-                } else {
-                    m_display_nodes[i] = {current, nullptr};
-                }
-                current = m_tree.move_down(current);
-            }
+            m_cursor_line = std::min<int>(m_cursor_line, rows - 1);
+            fill_rows(0, node);
         }
 
         std::vector<size_t> select() {
-            auto& [id, node] = m_display_nodes[m_cursor_line];
+            auto& row = m_display_nodes[m_cursor_line];
 
-            auto affected = m_tree.select(id, true);
+            if (row.node == nullptr) {
+                return {};
+            }
 
-            set_frame(m_columns, m_display_nodes.size());
+            return m_tree.select(row.id, true, m_order.empty());
+        }
 
-            return affected;
+        std::vector<size_t> select_node(const size_t id) {
+            return m_tree.select(id, true, false);
         }
 
         std::vector<size_t> unselect() {
-            auto& [id, node] = m_display_nodes[m_cursor_line];
+            auto& row = m_display_nodes[m_cursor_line];
 
-            auto affected = m_tree.select(id, false);
-
-            set_frame(m_columns, m_display_nodes.size());
+            if (row.node == nullptr) {
+                return {};
+            }
 
-            return affected;
+            return m_tree.select(row.id, false, m_order.empty());
         }
 
         void goto_root() {
-            auto& [selected_id, selected_node] = m_display_nodes[m_cursor_line];
-            auto root = m_tree.get_root(selected_id);
+            auto root = m_tree.get_root(m_display_nodes[m_cursor_line].id);
 
             int n = 0;
-            for (auto& [id, node] : m_display_nodes) {
-                if (id == root) {
+            for (auto& row : m_display_nodes) {
+                if (row.id == root) {
                     m_cursor_line = n;
                     return;
                 }
@@ -81,51 +120,74 @@ namespace wavy::selection {
             m_cursor_line = 0;
         }
 
-        bool search_for_node(const std::string& filter) {
-            auto& [selected_id, selected_node] = m_display_nodes[m_cursor_line];
-            if (auto result_id = m_tree.search_for_node(filter, selected_id)) {
-                int n = 0;
-                for (auto& [id, node] : m_display_nodes) {
-                    if (id == *result_id) {
-                        m_cursor_line = n;
-                        return true;
-                    }
-                    
-                    n++;
+        void begin_search() {
+            m_search_origin = m_display_nodes[m_cursor_line].id;
+            m_search_matches.clear();
+        }
+
+        size_t incremental_search(const std::string& filter) {
+            if (filter.empty()) {
+                m_search_matches.clear();
+            } else {
+                m_search_matches = m_tree.search(filter);
+            }
+
+            if (auto result_id = m_tree.next_match(m_search_matches, m_search_origin, true)) {
+                goto_node(*result_id);
+            } else {
+                goto_node(m_search_origin);
+            }
+
+            return m_search_matches.size();
+        }
+
+        void cancel_search() {
+            m_search_matches.clear();
+            goto_node(m_search_origin);
+        }
+
+        void next_match(const bool forward) {
+            if (auto result_id = m_tree.next_match(m_search_matches, m_display_nodes[m_cursor_line].id, forward)) {
+                goto_node(*result_id);
+            }
+        }
+
+        void goto_node(const size_t node_id) {
+            int n = 0;
+            for (auto& row : m_display_nodes) {
+                if (row.id == node_id) {
+                    m_cursor_line = n;
+                    return;
                 }
 
-                set_frame_from(m_columns, m_display_nodes.size(), *result_id);
-                m_cursor_line = 0;
-                return true;
+                n++;
             }
 
-            return false;
+            if (m_order.empty()) {
+                m_tree.reveal(node_id);
+            }
+            set_frame_from(m_columns, m_display_nodes.size(), node_id);
+            m_cursor_line = 0;
         }
 
         void collapse_toogle() {
-            auto& [id, node] = m_display_nodes[m_cursor_line];
+            auto id = m_display_nodes[m_cursor_line].id;
+
+            if (m_display_nodes[m_cursor_line].node == nullptr || !m_order.empty()) {
+                return;
+            }
 
             m_tree.collapse_toogle(id);
 
-            set_frame(m_columns, m_display_nodes.size());
+            fill_rows(m_cursor_line, id);
         }
 
         void move_up() {
             if (m_cursor_line > 0) {
                 m_cursor_line--;
-            } else {
-                auto first = m_display_nodes.begin()->first;
-                if (first > 0) {
-                    for (size_t i = m_display_nodes.size() - 1; i > 0; i--) {
-                        m_display_nodes[i] = m_display_nodes[i - 1];
-                    }
-                    auto next = m_tree.move_up(first);
-                    if (auto node = m_tree.get_node(next)) {
-                        *m_display_nodes.begin() = {next, *node};
-                    } else {
-                        *m_display_nodes.begin() = {next, nullptr};
-                    }
-                }
+            } else if (auto previous = preceding(m_display_nodes.begin()->id)) {
+                std::rotate(m_display_nodes.rbegin(), m_display_nodes.rbegin() + 1, m_display_nodes.rend());
+                *m_display_nodes.begin() = make_row(*previous);
             }
         }
 
@@ -134,16 +196,9 @@ namespace wavy::selection {
 
             if (m_cursor_line == m_display_nodes.size()) {
                 m_cursor_line--;
-                auto last = m_display_nodes.rbegin()->first;
-                for (size_t i = 0; i < m_display_nodes.size() - 1; i++) {
-                    m_display_nodes[i] = m_display_nodes[i + 1];
-                }
-                auto next = m_tree.move_down(last);
-                if (auto node = m_tree.get_node(next)) {
-                    *m_display_nodes.rbegin() = {next, *node};
-                } else {
-                    *m_display_nodes.rbegin() = {next, nullptr};
-                }
+                auto last = m_display_nodes.rbegin()->id;
+                std::rotate(m_display_nodes.begin(), m_display_nodes.begin() + 1, m_display_nodes.end());
+                *m_display_nodes.rbegin() = make_row(following(last));
             }
         }
 
@@ -157,7 +212,7 @@ namespace wavy::selection {
         std::string frame() const {
             std::string result;
             int n = 0;
-            for (const auto& [id, node] : m_display_nodes) {
+            for (const auto& [id, node, steps, path_name] : m_display_nodes) {
                 std::string line;
                 std::string style_prefix;
                 std::string style_postfix;
@@ -167,14 +222,15 @@ namespace wavy::selection {
                     style_prefix = cmd::begin_style<style_empty_row>();
                     style_postfix = cmd::end_style<style_empty_row>();
                 } else {
-                    auto name = node->name;
-                    auto [steps, path_name] = m_tree.path_name(id);
+                    auto& name = node->name;
 
                     line = std::string(steps, ' ');
                     style_prefix = cmd::begin_style<style_normal_row>();
                     style_postfix = cmd::end_style<style_normal_row>();
 
-                    if (node->collapsed && node->skip > 0) {
+                    if (!m_order.empty()) {
+                        line = " " + path_name + name;
+                    } else if (node->collapsed && node->skip > 0) {
                         line += "+";
                         line += path_name + node->name.substr(0, node->depth);
 
@@ -194,7 +250,12 @@ namespace wavy::selection {
                         line += name;
                     }
 
-                    line += std::string(m_columns - line.length(), ' ') + "\n";
+                    std::string annotation;
+                    if (id < m_annotations.size()) {
+                        annotation = m_annotations[id].substr(0, m_columns);
+                    }
+                    line.resize(m_columns - annotation.length(), ' ');
+                    line += annotation + "\n";
 
                     if (node->selected) {
                         style_prefix += cmd::begin_style<style_selected_row>();
@@ -235,9 +296,69 @@ namespace wavy::selection {
             cmd::styles::font::italic
         > style_selected_row;
 
+        struct display_row {
+            size_t id = 0;
+            const typename tree_directory<T>::node* node = nullptr;
+            size_t steps = 0;
+            std::string path;
+        };
+
+        display_row make_row(const size_t id) const {
+            if (auto node = m_tree.get_node(id)) {
+                auto [steps, path] = m_tree.path_name(id);
+                return {id, *node, steps, std::move(path)};
+            }
+            return {id, nullptr, 0, {}};
+        }
+
+        void fill_rows(const size_t from, const size_t node) {
+            auto current = node;
+
+            for (auto i = from; i < m_display_nodes.size(); i++) {
+                m_display_nodes[i] = make_row(current);
+                current = following(current);
+            }
+        }
+
+        size_t following(const size_t id) const {
+            if (m_order.empty() || id >= m_tree.size()) {
+                return m_tree.move_down(id);
+            }
+
+            auto rank = m_rank[id] + 1;
+            return rank < m_order.size() ? m_order[rank] : m_tree.size();
+        }
+
+        std::optional<size_t> preceding(const size_t id) const {
+            if (m_order.empty()) {
+                if (id > 0) {
+                    return m_tree.move_up(id);
+                }
+                return std::nullopt;
+            }
+
+            if (id > m_tree.size()) {
+                return id - 1;
+            }
+            if (id == m_tree.size()) {
+                return m_order.back();
+            }
+            if (m_rank[id] > 0) {
+                return m_order[m_rank[id] - 1];
+            }
+            return std::nullopt;
+        }
+
         tree_directory<T> m_tree;
-        std::vector<std::pair<size_t, const typename tree_directory<T>::node*>> m_display_nodes;
+        std::vector<display_row> m_display_nodes;
         int m_cursor_line = 0;
         size_t m_columns;
+
+        size_t m_search_origin = 0;
+        std::vector<size_t> m_search_matches;
+
+        std::vector<size_t> m_order;
+        std::vector<size_t> m_rank;
+        std::vector<std::string> m_annotations;
     };
 }
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <bit>
+#include <stdint.h>
+#include <vector>
+
+#include "time_index.h"
+
+namespace wavy::util {
+    struct activity {
+        size_t toggles = 0;
+        size_t high = 0;
+        size_t span = 0;
+
+        double duty() const {
+            return span > 0 ? static_cast<double>(high) / span : 0;
+        }
+    };
+
+    template<typename T>
+    class activity_index {
+    public:
+        constexpr static size_t block_size = time_index::block_size;
+
+        void reset(const size_t width) {
+            constexpr size_t bits = sizeof(T) * 8;
+
+            *this = {};
+            m_last.resize((width + bits - 1) / bits);
+            m_last_mask = width % bits == 0 ? ~static_cast<T>(0) : (static_cast<T>(1) << (width % bits)) - 1;
+        }
+
+        void add(const std::vector<T>& value, const size_t duration) {
+            bool was_high = false;
+            size_t toggled = 0;
+
+            for (size_t i = 0; i < m_last.size(); i++) {
+                T v = i < value.size() ? value[i] : 0;
+                v &= i + 1 < m_last.size() ? ~static_cast<T>(0) : m_last_mask;
+
+                was_high |= m_last[i] != 0;
+                toggled += std::popcount(static_cast<T>(m_last[i] ^ v));
+                m_last[i] = v;
+            }
+
+            if (m_items++ > 0) {
+                m_high += was_high ? duration : 0;
+                m_toggles += toggled;
+
+                if ((m_items - 1) % block_size == 0) {
+                    m_blocks.push_back({m_toggles, m_high});
+                }
+            }
+        }
+
+        const std::vector<T>& last() const {
+            return m_last;
+        }
+
+        std::pair<size_t, size_t> block_start(const size_t block) const {
+            if (block == 0) {
+                return {0, 0};
+            }
+            return m_blocks[block - 1];
+        }
+
+        size_t toggles(const std::vector<T>& from, const std::vector<T>& to) const {
+            size_t result = 0;
+            for (size_t i = 0; i < std::max(from.size(), to.size()); i++) {
+                auto l = i < from.size() ? from[i] : 0;
+                auto r = i < to.size() ? to[i] : 0;
+                result += std::popcount(static_cast<T>((l ^ r) & mask(i)));
+            }
+            return result;
+        }
+
+        bool high(const std::vector<T>& value) const {
+            for (size_t i = 0; i < value.size(); i++) {
+                if ((value[i] & mask(i)) != 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        size_t memory_usage() const {
+            return m_blocks.capacity() * sizeof(m_blocks[0]) + m_last.capacity() * sizeof(T);
+        }
+    private:
+        T mask(const size_t word) const {
+            return word + 1 < m_last.size() ? ~static_cast<T>(0) : word + 1 == m_last.size() ? m_last_mask : 0;
+        }
+
+        std::vector<std::pair<size_t, size_t>> m_blocks;
+        std::vector<T> m_last;
+        size_t m_items = 0;
+        size_t m_toggles = 0;
+        size_t m_high = 0;
+        T m_last_mask = 0;
+    };
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace wavy::util {
+    class background_worker {
+    public:
+        ~background_worker() {
+            {
+                std::unique_lock ul(m_mutex);
+                m_jobs.clear();
+                m_stop = true;
+            }
+            m_cv.notify_all();
+
+            if (m_thread.joinable()) {
+                m_thread.join();
+            }
+        }
+
+        void replace_jobs(std::deque<std::function<void()>>&& jobs) {
+            {
+                std::unique_lock ul(m_mutex);
+                m_jobs = std::move(jobs);
+
+                if (!m_thread.joinable()) {
+                    m_thread = std::thread([this]() {
+                        run();
+                    });
+                }
+            }
+            m_cv.notify_all();
+        }
+
+        void cancel() {
+            std::unique_lock ul(m_mutex);
+            m_jobs.clear();
+            m_idle_cv.wait(ul, [this]() {
+                return !m_busy;
+            });
+        }
+    private:
+        void run() {
+            std::unique_lock ul(m_mutex);
+
+            while (true) {
+                m_cv.wait(ul, [this]() {
+                    return m_stop || !m_jobs.empty();
+                });
+
+                if (m_stop) {
+                    return;
+                }
+
+                auto job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+                m_busy = true;
+
+                ul.unlock();
+                job();
+                ul.lock();
+
+                m_busy = false;
+                m_idle_cv.notify_all();
+            }
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::condition_variable m_idle_cv;
+        std::deque<std::function<void()>> m_jobs;
+        std::thread m_thread;
+        bool m_busy = false;
+        bool m_stop = false;
+    };
+}
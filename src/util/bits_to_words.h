@@ -11,6 +11,7 @@ namespace wavy::util {
             m_width = width;
             m_words.clear();
             m_current_insert_offset = 0;
+            m_number_of_items = 0;
 
             m_num_words = m_width / (sizeof(T) * 8);
             if ((m_width % (sizeof(T) * 8)) > 0) {
@@ -35,8 +36,10 @@ namespace wavy::util {
                 
                 if (word_index < word.size()) {
                     add_word(word[word_index], offset);
-                    word_index++;
+                } else {
+                    add_word(0, offset);
                 }
+                word_index++;
             }
 
             m_number_of_items++;
@@ -56,6 +59,16 @@ namespace wavy::util {
                 }
 
                 m_current.resize(m_num_words);
+
+                auto bit = item * m_width;
+                auto offset = bit % (sizeof(T) * 8);
+                m_word_counter = bit / (sizeof(T) * 8);
+                if (offset > 0 && m_item < m_number_of_items) {
+                    m_stored_word = m_words->at(m_word_counter) >> offset;
+                    m_bit_counter = sizeof(T) * 8 - offset;
+                    m_word_counter++;
+                }
+
                 next_word();
             }
             bool operator==(const iterator& it) const {
@@ -146,7 +159,9 @@ namespace wavy::util {
                         if (dest_bit_counter == sizeof(T) * 8) {
                             dest_bit_counter = fit_into_next_word;
                             dest_word_counter++;
-                            m_current[dest_word_counter] = ((tmp >> fit_into_current_word) & ((1UL << fit_into_next_word) - 1));
+                            if (dest_word_counter < m_current.size()) {
+                                m_current[dest_word_counter] = fit_into_next_word > 0 ? ((tmp >> fit_into_current_word) & ((1UL << fit_into_next_word) - 1)) : 0;
+                            }
                         }
                     }
                     m_item++;
@@ -202,6 +217,13 @@ namespace wavy::util {
         iterator end() const {
             return iterator(m_words, m_width, m_number_of_items, m_number_of_items);
         }
+        iterator at(const size_t item) const {
+            return iterator(m_words, m_width, item, m_number_of_items);
+        }
+
+        size_t size() const {
+            return m_number_of_items;
+        }
     private:
         T get_current() {
             if (m_words.empty()) {
@@ -218,11 +240,9 @@ namespace wavy::util {
         }   
         void add_word(const T value, const size_t n) {
             auto data_width = 8 * sizeof(T);
-            size_t mask = 1UL << n;
-            mask = mask - 1;
-
-            if (n == 64) {
-                mask = ~0;
+            size_t mask = ~0UL;
+            if (n < 64) {
+                mask = (1UL << n) - 1;
             }
 
             if (m_current_insert_offset == data_width) {
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <bit>
+#include <stdint.h>
+#include <vector>
+
+#include "time_index.h"
+
+namespace wavy::util {
+    class block_hash {
+    public:
+        constexpr static size_t block_size = time_index::block_size;
+
+        template<typename T>
+        void add(const std::vector<T>& value, const size_t delta) {
+            for (const auto word : value) {
+                mix(word);
+            }
+            mix(delta);
+
+            if (++m_items % block_size == 0) {
+                m_blocks.push_back(m_current);
+                m_current = seed;
+            }
+        }
+
+        size_t matching_blocks(const block_hash& other) const {
+            size_t result = 0;
+            while (result < m_blocks.size() && result < other.m_blocks.size() && m_blocks[result] == other.m_blocks[result]) {
+                result++;
+            }
+            return result;
+        }
+
+        bool operator==(const block_hash& other) const {
+            return m_items == other.m_items && m_current == other.m_current && m_blocks == other.m_blocks;
+        }
+
+        size_t memory_usage() const {
+            return m_blocks.capacity() * sizeof(uint64_t);
+        }
+    private:
+        constexpr static uint64_t seed = 0xcbf29ce484222325;
+
+        void mix(const uint64_t value) {
+            m_current = (std::rotl(m_current, 5) ^ value) * 0x9e3779b97f4a7c15;
+        }
+
+        std::vector<uint64_t> m_blocks;
+        uint64_t m_current = seed;
+        size_t m_items = 0;
+    };
+}
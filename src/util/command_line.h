@@ -0,0 +1,41 @@
+#pragma once
+
+#include <charconv>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace wavy::util {
+    inline std::vector<std::string> split_by_space(const std::string& s) {
+        std::vector<std::string> result;
+        std::string current;
+
+        for (const auto c : s) {
+            if (c == ' ' || c == '\t') {
+                if (!current.empty()) {
+                    result.push_back(current);
+                    current.clear();
+                }
+            } else {
+                current += c;
+            }
+        }
+        if (!current.empty()) {
+            result.push_back(current);
+        }
+
+        return result;
+    }
+
+    template<typename T>
+    std::optional<T> parse_number(const std::string& s) {
+        T result;
+        auto [end, error] = std::from_chars(s.data(), s.data() + s.size(), result);
+
+        if (error != std::errc() || end != s.data() + s.size()) {
+            return std::nullopt;
+        }
+
+        return result;
+    }
+}
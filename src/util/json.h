@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+namespace wavy::util {
+    inline std::string escape_json(const std::string& text) {
+        constexpr char hex[] = "0123456789abcdef";
+
+        std::string result;
+        for (const auto c : text) {
+            switch (c) {
+                case '"': result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\n': result += "\\n"; break;
+                case '\r': result += "\\r"; break;
+                case '\t': result += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        result += "\\u00";
+                        result += hex[c >> 4];
+                        result += hex[c & 0xf];
+                    } else {
+                        result += c;
+                    }
+                    break;
+            }
+        }
+        return result;
+    }
+}
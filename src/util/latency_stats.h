@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+namespace wavy::util {
+    class latency_stats {
+    public:
+        void add(const double value) {
+            m_values.push_back(value);
+            m_sorted = false;
+        }
+
+        size_t count() const {
+            return m_values.size();
+        }
+
+        double percentile(const double p) {
+            if (m_values.empty()) {
+                return 0;
+            }
+            sort();
+
+            auto index = static_cast<size_t>(p * (m_values.size() - 1) + 0.5);
+            return m_values[std::min(index, m_values.size() - 1)];
+        }
+
+        double max() {
+            return percentile(1.0);
+        }
+
+        double mean() const {
+            if (m_values.empty()) {
+                return 0;
+            }
+
+            double sum = 0;
+            for (const auto v : m_values) {
+                sum += v;
+            }
+            return sum / m_values.size();
+        }
+    private:
+        void sort() {
+            if (!m_sorted) {
+                std::sort(m_values.begin(), m_values.end());
+                m_sorted = true;
+            }
+        }
+
+        std::vector<double> m_values;
+        bool m_sorted = true;
+    };
+}
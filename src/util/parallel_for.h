@@ -0,0 +1,29 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace wavy::util {
+    template<typename F>
+    void parallel_for(const size_t n, const F& f) {
+        size_t num_threads = std::max(1U, std::thread::hardware_concurrency());
+        num_threads = std::min(num_threads, n);
+
+        std::atomic<size_t> next = 0;
+        std::vector<std::thread> threads;
+
+        for (size_t t = 0; t < num_threads; t++) {
+            threads.emplace_back([&]() {
+                for (auto i = next++; i < n; i = next++) {
+                    f(i);
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+}
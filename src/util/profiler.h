@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+namespace wavy::util {
+    class profiler {
+    public:
+        struct frame_counters {
+            double draw_us = 0;
+            double style_us = 0;
+            double output_us = 0;
+            size_t transitions = 0;
+            size_t cache_hits = 0;
+            size_t cache_misses = 0;
+            size_t rendered_frames = 0;
+
+            double total_us() const {
+                return draw_us + style_us + output_us;
+            }
+        };
+
+        struct memory_counters {
+            size_t tree_nodes = 0;
+            size_t value_words = 0;
+            size_t time_deltas = 0;
+        };
+
+        class timer {
+        public:
+            timer(profiler* p, double frame_counters::* counter) : m_profiler(p), m_counter(counter), m_start(std::chrono::steady_clock::now()) {}
+
+            ~timer() {
+                if (m_profiler != nullptr) {
+                    m_profiler->current().*m_counter += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_start).count();
+                }
+            }
+        private:
+            profiler* m_profiler;
+            double frame_counters::* m_counter;
+            std::chrono::steady_clock::time_point m_start;
+        };
+
+        frame_counters& current() {
+            return m_current;
+        }
+
+        const frame_counters& last() const {
+            return m_last;
+        }
+
+        void set_memory(const memory_counters& memory) {
+            m_memory = memory;
+        }
+
+        const memory_counters& memory() const {
+            return m_memory;
+        }
+
+        void set_recording(const bool recording) {
+            m_recording = recording;
+        }
+
+        void finish_frame(const size_t cache_hits, const size_t cache_misses, const size_t rendered_frames) {
+            m_current.cache_hits = cache_hits - std::min(cache_hits, m_cache_hits);
+            m_current.cache_misses = cache_misses - std::min(cache_misses, m_cache_misses);
+            m_current.rendered_frames = rendered_frames;
+            m_cache_hits = cache_hits;
+            m_cache_misses = cache_misses;
+
+            m_last = m_current;
+            if (m_recording) {
+                m_frames.push_back(m_current);
+            }
+            m_current = {};
+        }
+
+        void write_json(std::ostream& out) const {
+            frame_counters total;
+            frame_counters peak;
+            for (const auto& f : m_frames) {
+                total.draw_us += f.draw_us;
+                total.style_us += f.style_us;
+                total.output_us += f.output_us;
+                total.transitions += f.transitions;
+                total.cache_hits += f.cache_hits;
+                total.cache_misses += f.cache_misses;
+                peak.draw_us = std::max(peak.draw_us, f.draw_us);
+                peak.style_us = std::max(peak.style_us, f.style_us);
+                peak.output_us = std::max(peak.output_us, f.output_us);
+                peak.transitions = std::max(peak.transitions, f.transitions);
+                peak.rendered_frames = std::max(peak.rendered_frames, f.rendered_frames);
+            }
+
+            out << "{\n";
+            out << "  \"memory\": {\"tree_nodes\": " << m_memory.tree_nodes << ", \"value_words\": " << m_memory.value_words;
+            out << ", \"time_deltas\": " << m_memory.time_deltas << ", \"rendered_frames_peak\": " << peak.rendered_frames << "},\n";
+            out << "  \"total\": ";
+            write_counters(out, total);
+            out << ",\n  \"peak\": ";
+            write_counters(out, peak);
+            out << ",\n  \"frames\": [\n";
+            for (size_t i = 0; i < m_frames.size(); i++) {
+                out << "    ";
+                write_counters(out, m_frames[i]);
+                out << (i + 1 < m_frames.size() ? ",\n" : "\n");
+            }
+            out << "  ]\n}\n";
+        }
+    private:
+        static void write_counters(std::ostream& out, const frame_counters& f) {
+            out << "{\"draw_us\": " << f.draw_us << ", \"style_us\": " << f.style_us << ", \"output_us\": " << f.output_us;
+            out << ", \"transitions\": " << f.transitions << ", \"cache_hits\": " << f.cache_hits << ", \"cache_misses\": " << f.cache_misses;
+            out << ", \"rendered_frames\": " << f.rendered_frames << "}";
+        }
+
+        frame_counters m_current;
+        frame_counters m_last;
+        memory_counters m_memory;
+        std::vector<frame_counters> m_frames;
+        size_t m_cache_hits = 0;
+        size_t m_cache_misses = 0;
+        bool m_recording = false;
+    };
+}
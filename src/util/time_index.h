@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+namespace wavy::util {
+    class time_index {
+    public:
+        constexpr static size_t block_size = 64;
+
+        void add(const uint32_t size) {
+            m_count++;
+            m_total += size;
+
+            if (m_count % block_size == 0) {
+                m_blocks.push_back(m_total);
+            }
+        }
+
+        std::pair<size_t, size_t> find(const size_t time) const {
+            auto it = std::upper_bound(m_blocks.begin(), m_blocks.end(), time);
+            size_t block = std::distance(m_blocks.begin(), it);
+
+            if (block == 0) {
+                return {0, 0};
+            }
+
+            return {block * block_size, m_blocks[block - 1]};
+        }
+
+        size_t block_start(const size_t block) const {
+            if (block == 0) {
+                return 0;
+            }
+            return m_blocks[block - 1];
+        }
+
+        size_t num_blocks() const {
+            return m_blocks.size() + 1;
+        }
+
+        size_t total() const {
+            return m_total;
+        }
+
+        size_t memory_usage() const {
+            return m_blocks.capacity() * sizeof(size_t);
+        }
+    private:
+        std::vector<size_t> m_blocks;
+        size_t m_count = 0;
+        size_t m_total = 0;
+    };
+}
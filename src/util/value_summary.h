@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "time_index.h"
+
+namespace wavy::util {
+    template<typename T>
+    class value_summary {
+    public:
+        constexpr static size_t block_size = time_index::block_size;
+
+        struct block {
+            T min;
+            T max;
+            T any_set;
+            T all_set;
+        };
+
+        void add(const T value) {
+            if (m_count % block_size == 0) {
+                m_blocks.push_back({value, value, value, value});
+            } else {
+                auto& b = m_blocks.back();
+                b.min = std::min(b.min, value);
+                b.max = std::max(b.max, value);
+                b.any_set |= value;
+                b.all_set &= value;
+            }
+            m_count++;
+        }
+
+        const block& at(const size_t n) const {
+            return m_blocks[n];
+        }
+
+        size_t size() const {
+            return m_blocks.size();
+        }
+
+        size_t memory_usage() const {
+            return m_blocks.capacity() * sizeof(block);
+        }
+    private:
+        std::vector<block> m_blocks;
+        size_t m_count = 0;
+    };
+}
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "style.h"
+
+#include "signal.h"
+#include "value_format.h"
+
+namespace wavy::waveform {
+    template<typename T>
+    class cycle_table {
+    public:
+        struct column {
+            std::string name;
+            signal<T>* data;
+        };
+
+        ~cycle_table() {
+            close();
+        }
+
+        void set_prepare(std::function<void(size_t, size_t)> prepare) {
+            m_prepare = std::move(prepare);
+        }
+
+        void open(signal<T>* clock, std::vector<column> columns, const size_t max_time, const size_t time, const radix r) {
+            close();
+
+            m_clock = clock;
+            m_columns = std::move(columns);
+            m_radix = r;
+
+            m_clock->activate(max_time);
+            for (auto& c : m_columns) {
+                c.data->activate(max_time);
+            }
+
+            m_edges.clear();
+            m_cursor_row = 0;
+            m_first_column = 0;
+
+            if (auto edge = time > 0 ? next_rising(time - 1) : first_rising()) {
+                m_top_cycle = rising_edges_before(*edge);
+                m_edges.push_back(*edge);
+            }
+            fill_edges();
+            update_frame();
+        }
+
+        void close() {
+            if (m_clock != nullptr) {
+                m_clock->deactivate();
+                for (auto& c : m_columns) {
+                    c.data->deactivate();
+                }
+                m_clock = nullptr;
+                m_columns.clear();
+            }
+        }
+
+        bool is_open() const {
+            return m_clock != nullptr;
+        }
+
+        void set_frame(const size_t columns, const size_t rows) {
+            m_width = columns;
+            m_rows = rows;
+
+            if (is_open()) {
+                while (m_edges.size() > table_rows()) {
+                    m_edges.pop_back();
+                }
+                fill_edges();
+                m_cursor_row = std::min(m_cursor_row, m_edges.size() - std::min<size_t>(m_edges.size(), 1));
+                update_frame();
+            }
+        }
+
+        void move_down(const size_t n = 1) {
+            if (m_edges.empty()) {
+                return;
+            }
+
+            auto below = m_edges.size() - 1 - m_cursor_row;
+            m_cursor_row += std::min(n, below);
+
+            for (auto scroll = n - std::min(n, below); scroll > 0 && m_edges.size() == table_rows(); scroll--) {
+                auto next = next_rising(m_edges.back());
+                if (!next) {
+                    break;
+                }
+                m_edges.pop_front();
+                m_edges.push_back(*next);
+                m_top_cycle++;
+            }
+            update_frame();
+        }
+
+        void move_up(const size_t n = 1) {
+            if (m_edges.empty()) {
+                return;
+            }
+
+            auto above = m_cursor_row;
+            m_cursor_row -= std::min(n, above);
+
+            for (auto scroll = n - std::min(n, above); scroll > 0; scroll--) {
+                auto previous = previous_rising(m_edges.front());
+                if (!previous) {
+                    break;
+                }
+                m_edges.push_front(*previous);
+                if (m_edges.size() > table_rows()) {
+                    m_edges.pop_back();
+                }
+                m_top_cycle--;
+            }
+            update_frame();
+        }
+
+        void move_left(const size_t n = 1) {
+            m_first_column -= std::min(n, m_first_column);
+            update_frame();
+        }
+
+        void move_right(const size_t n = 1) {
+            m_first_column = std::min(m_first_column + n, m_columns.size() - std::min<size_t>(m_columns.size(), 1));
+            update_frame();
+        }
+
+        std::optional<size_t> cursor_time() const {
+            if (m_cursor_row < m_edges.size()) {
+                return m_edges[m_cursor_row];
+            }
+            return std::nullopt;
+        }
+
+        const std::string& frame() const {
+            return m_frame;
+        }
+    private:
+        size_t table_rows() const {
+            return std::max<size_t>(m_rows, 2) - 1;
+        }
+
+        static bool high(const std::vector<T>& words) {
+            return !words.empty() && (words[0] & 1) != 0;
+        }
+
+        std::optional<size_t> first_rising() const {
+            auto pos = m_clock->position();
+            if (high(pos.words())) {
+                return 0;
+            }
+            return next_rising(0);
+        }
+
+        std::optional<size_t> next_rising(const size_t time) const {
+            auto pos = m_clock->position();
+            pos.seek(time);
+
+            auto level = high(pos.words());
+            while (pos.move_right()) {
+                auto current = high(pos.words());
+                if (current && !level && pos.duration() > 0) {
+                    return pos.time();
+                }
+                level = current;
+            }
+            return std::nullopt;
+        }
+
+        std::optional<size_t> previous_rising(const size_t time) const {
+            if (time == 0) {
+                return std::nullopt;
+            }
+
+            auto pos = m_clock->position();
+            pos.seek(time - 1);
+
+            while (true) {
+                auto current = high(pos.words()) && pos.duration() > 0;
+                if (!pos.move_left()) {
+                    return current ? std::optional<size_t>(0) : std::nullopt;
+                }
+                if (current && !high(pos.words())) {
+                    pos.move_right();
+                    return pos.time();
+                }
+            }
+        }
+
+        size_t rising_edges_before(const size_t time) const {
+            if (time == 0) {
+                return 0;
+            }
+
+            auto initial = m_clock->position();
+            auto toggles = m_clock->activity(0, (time - 1) / 1024).toggles;
+            return high(initial.words()) ? 1 + toggles / 2 : (toggles + 1) / 2;
+        }
+
+        void fill_edges() {
+            while (!m_edges.empty() && m_edges.size() < table_rows()) {
+                auto next = next_rising(m_edges.back());
+                if (!next) {
+                    break;
+                }
+                m_edges.push_back(*next);
+            }
+        }
+
+        std::string fit(std::string text, const size_t width) const {
+            if (text.length() > width) {
+                auto dots = std::min<size_t>(2, width);
+                text = std::string(dots, '.') + text.substr(text.length() - (width - dots));
+            }
+            return std::string(width - text.length(), ' ') + text;
+        }
+
+        void update_frame() {
+            m_frame.clear();
+            if (m_edges.empty()) {
+                m_frame = std::string(m_width, ' ') + "\n";
+                for (size_t row = 1; row < std::max<size_t>(m_rows, 1); row++) {
+                    m_frame += std::string(m_width, ' ') + "\n";
+                }
+                return;
+            }
+
+            if (m_prepare) {
+                m_prepare(m_edges.front() - std::min<size_t>(m_edges.front(), 1), m_edges.back());
+            }
+
+            auto cycle_width = std::max<size_t>(std::to_string(m_top_cycle + m_edges.size()).length(), 5);
+            auto time_width = std::max<size_t>(format_time(m_edges.back()).length(), 4);
+
+            std::vector<size_t> widths;
+            std::vector<wave_position<T>> positions;
+            for (auto i = m_first_column; i < m_columns.size(); i++) {
+                widths.push_back(std::clamp<size_t>(std::max(m_columns[i].name.length(), value_digits(m_columns[i].data->width(), m_radix)), 1, 32));
+                positions.push_back(m_columns[i].data->position());
+                positions.back().seek(m_edges.front() - std::min<size_t>(m_edges.front(), 1));
+            }
+
+            auto line = fit("cycle", cycle_width) + " " + fit("time", time_width) + " |";
+            for (size_t i = 0; i < widths.size(); i++) {
+                line += " " + fit(m_columns[m_first_column + i].name, widths[i]);
+            }
+            line.resize(m_width, ' ');
+            m_frame += cmd::add_style<cmd::styles::font::bold, cmd::styles::colors::background::extended<236>, cmd::styles::colors::foreground::extended<214>>(line) + "\n";
+
+            for (size_t row = 0; row < table_rows(); row++) {
+                line.clear();
+
+                if (row < m_edges.size()) {
+                    auto sample = m_edges[row] - std::min<size_t>(m_edges[row], 1);
+
+                    line = fit(std::to_string(m_top_cycle + row), cycle_width) + " " + fit(format_time(m_edges[row]), time_width) + " |";
+                    for (size_t i = 0; i < positions.size(); i++) {
+                        positions[i].move_to(sample);
+                        line += " " + fit(format_value(positions[i].words(), m_columns[m_first_column + i].data->width(), m_radix), widths[i]);
+                    }
+                }
+                line.resize(m_width, ' ');
+
+                if (row == m_cursor_row) {
+                    m_frame += cmd::add_style<cmd::styles::font::bold, cmd::styles::colors::background::extended<123>>(line) + "\n";
+                } else if (row % 2 > 0) {
+                    m_frame += cmd::add_style<cmd::styles::colors::background::extended<240>>(line) + "\n";
+                } else {
+                    m_frame += cmd::add_style<cmd::styles::colors::background::extended<241>>(line) + "\n";
+                }
+            }
+        }
+
+        signal<T>* m_clock = nullptr;
+        std::vector<column> m_columns;
+        radix m_radix = radix::hex;
+        std::function<void(size_t, size_t)> m_prepare;
+
+        std::deque<size_t> m_edges;
+        size_t m_top_cycle = 0;
+        size_t m_cursor_row = 0;
+        size_t m_first_column = 0;
+
+        size_t m_width = 0;
+        size_t m_rows = 0;
+        std::string m_frame;
+    };
+}
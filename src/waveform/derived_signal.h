@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+
+#include "signal.h"
+#include "signal_expression.h"
+
+namespace wavy::waveform {
+    template<typename T>
+    class derived_signal {
+    public:
+        derived_signal(signal_expression<T>&& expression) : m_expression(std::move(expression)) {
+            m_result.init(m_expression.width());
+        }
+
+        derived_signal(const derived_signal&) = delete;
+        derived_signal& operator=(const derived_signal&) = delete;
+
+        ~derived_signal() {
+            if (m_active) {
+                deactivate();
+            }
+        }
+
+        signal<T>& data() {
+            return m_result;
+        }
+
+        void activate(const size_t max_time) {
+            for (auto* operand : m_expression.operands()) {
+                operand->activate(max_time);
+            }
+
+            m_max_time = max_time;
+            m_end = max_time * 1024;
+            m_active = true;
+
+            evaluate_until(0);
+            m_result.activate(max_time);
+        }
+
+        void deactivate() {
+            m_result.deactivate();
+            for (auto* operand : m_expression.operands()) {
+                operand->deactivate();
+            }
+            m_active = false;
+        }
+
+        bool covers(const size_t from, const size_t to) const {
+            return from >= m_start && (to < m_horizon || m_horizon >= m_end);
+        }
+
+        void ensure(const size_t from, const size_t to) {
+            if (covers(from, to)) {
+                return;
+            }
+
+            m_result.unseal();
+            if (from < m_start || from > m_horizon) {
+                m_result.clear();
+                m_start = from / 1024 * 1024;
+                m_horizon = m_start;
+                m_empty = true;
+            }
+            evaluate_until(to);
+            m_result.seal(m_max_time);
+        }
+    private:
+        void evaluate_until(const size_t time) {
+            std::vector<wave_position<T>> positions;
+            std::vector<const std::vector<T>*> values;
+
+            for (auto* operand : m_expression.operands()) {
+                positions.push_back(operand->position());
+                positions.back().seek(m_horizon);
+            }
+            values.resize(positions.size());
+
+            auto current = m_horizon;
+            while (true) {
+                for (size_t i = 0; i < positions.size(); i++) {
+                    values[i] = &positions[i].words();
+                }
+
+                auto value = m_expression.evaluate(values);
+                if (m_empty || value != m_last) {
+                    m_result.add_transition(value, m_empty ? 0 : current / 1024);
+                    m_last = std::move(value);
+                    m_empty = false;
+                }
+
+                auto next = m_end;
+                for (const auto& pos : positions) {
+                    next = std::min(next, pos.time() + pos.duration());
+                }
+
+                if (next > time || next >= m_end) {
+                    m_horizon = next;
+                    return;
+                }
+
+                for (auto& pos : positions) {
+                    if (pos.time() + pos.duration() == next) {
+                        pos.move_right();
+                    }
+                }
+                current = next;
+            }
+        }
+
+        signal_expression<T> m_expression;
+        signal<T> m_result;
+        std::vector<T> m_last;
+        bool m_empty = true;
+        bool m_active = false;
+
+        size_t m_max_time = 0;
+        size_t m_end = 0;
+        size_t m_start = 0;
+        size_t m_horizon = 0;
+    };
+}
@@ -2,8 +2,14 @@
 
 #include <vector>
 #include <memory>
+#include <optional>
 
+#include "util/activity_index.h"
 #include "util/bits_to_words.h"
+#include "util/block_hash.h"
+#include "util/time_index.h"
+#include "util/value_summary.h"
+#include "value_filter.h"
 #include "wave.h"
 
 namespace wavy::waveform {
@@ -12,18 +18,40 @@ namespace wavy::waveform {
     public:
         void init(const int width) {
             m_converter.reset(width);
+            m_activity.reset(width);
         }
         
         void activate(const size_t max_time) {
+            if (m_active++ == 0) {
+                seal(max_time);
+                m_wave = std::make_unique<wave<T>>(m_converter, m_sizes, m_index);
+            }
+        }
+
+        void deactivate() {
+            if (--m_active == 0) {
+                unseal();
+                m_wave = nullptr;
+            }
+        }
+
+        void seal(const size_t max_time) {
             auto delta = max_time - m_current_time;
             m_sizes.push_back(delta + 128);
-
-            m_wave = std::make_unique<wave<T>>(m_converter, m_sizes);
         }
 
-        void deactivate() {
+        void unseal() {
             m_sizes.pop_back();
-            m_wave = nullptr;
+        }
+
+        void clear() {
+            m_converter.reset(m_converter.width());
+            m_sizes.clear();
+            m_index = {};
+            m_summary = {};
+            m_activity.reset(m_converter.width());
+            m_hash = {};
+            m_current_time = 0;
         }
 
         void add_transition(const std::string& value, const size_t time) {
@@ -46,26 +74,193 @@ namespace wavy::waveform {
                 converted.push_back(current);
             }
 
+            add_transition(converted, time);
+        }
+
+        void add_transition(const std::vector<T>& converted, const size_t time) {
+            if (m_converter.size() == 0 && time > 0) {
+                m_converter.add({});
+                m_activity.add({}, 0);
+                m_hash.add(m_activity.last(), 0);
+                summarize({});
+            }
+
             m_converter.add(converted);
+            m_activity.add(converted, time - m_current_time);
+            m_hash.add(m_activity.last(), time - m_current_time);
+            summarize(converted);
 
-            if (time == 0) {
-                m_current_time = time;
-            } else {
+            if (m_converter.size() > 1) {
                 auto delta = time - m_current_time;
 
                 m_sizes.push_back(delta);
-
-                m_current_time = time;
+                m_index.add(delta);
             }
+            m_current_time = time;
         }
 
         wave<T>& drawn_wave() {
             return *m_wave;
         }
+
+        wave<T> detached_wave() const {
+            return wave<T>(m_converter, m_sizes, m_index);
+        }
+
+        size_t width() const {
+            return m_converter.width();
+        }
+
+        std::optional<size_t> next_transition(const size_t time) const {
+            auto pos = position();
+            pos.seek(time);
+
+            if (pos.next_change()) {
+                return pos.time();
+            }
+            return std::nullopt;
+        }
+
+        std::optional<size_t> previous_transition(const size_t time) const {
+            auto pos = position();
+            pos.seek(time);
+
+            if (pos.run_start()) {
+                return pos.time();
+            }
+            return std::nullopt;
+        }
+
+        std::optional<size_t> find_value(const value_filter<T>& filter, const size_t time) const {
+            auto pos = position();
+            pos.seek(time);
+
+            while (true) {
+                auto next = pos.item() + 1;
+
+                if (m_summary.size() > 0 && next % util::time_index::block_size == 0) {
+                    auto block = next / util::time_index::block_size;
+                    while (block < m_summary.size() && !filter.may_match(m_summary.at(block))) {
+                        block++;
+                    }
+
+                    if (block == m_summary.size()) {
+                        return std::nullopt;
+                    }
+                    if (block > next / util::time_index::block_size) {
+                        pos.seek_block(block);
+                        if (filter.matches(pos.words())) {
+                            return pos.time();
+                        }
+                        continue;
+                    }
+                }
+
+                if (!pos.move_right()) {
+                    return std::nullopt;
+                }
+                if (filter.matches(pos.words())) {
+                    return pos.time();
+                }
+            }
+        }
+
+        util::activity activity(const size_t from, const size_t to) const {
+            auto [toggles_to, high_to] = accumulated(to);
+            auto [toggles_from, high_from] = accumulated(from);
+
+            return {toggles_to - toggles_from, high_to - high_from, to - from};
+        }
+
+        std::optional<size_t> first_difference(const signal& other, const size_t end) const {
+            if (width() != other.width()) {
+                return 0;
+            }
+            if (m_hash == other.m_hash) {
+                return std::nullopt;
+            }
+
+            auto blocks = m_hash.matching_blocks(other.m_hash);
+            auto current = blocks > 0 ? m_index.block_start(blocks - 1) * 1024 : 0;
+
+            auto pos = position();
+            auto other_pos = other.position();
+            pos.seek(current);
+            other_pos.seek(current);
+
+            while (current < end) {
+                if (pos.words() != other_pos.words()) {
+                    return current;
+                }
+
+                auto next = pos.time() + pos.duration();
+                auto other_next = other_pos.time() + other_pos.duration();
+                current = std::min(next, other_next);
+
+                auto moved = next == current && pos.move_right();
+                moved = (other_next == current && other_pos.move_right()) || moved;
+                if (!moved) {
+                    break;
+                }
+
+                while (pos.duration() == 0 && pos.move_right()) {}
+                while (other_pos.duration() == 0 && other_pos.move_right()) {}
+            }
+            return std::nullopt;
+        }
+
+        size_t value_memory() const {
+            return m_converter.data().capacity() * sizeof(T) + m_summary.memory_usage();
+        }
+
+        size_t delta_memory() const {
+            return m_sizes.capacity() * sizeof(uint32_t) + m_index.memory_usage() + m_activity.memory_usage() + m_hash.memory_usage();
+        }
+
+        wave_position<T> position() const {
+            wave_position<T> pos(m_converter, m_sizes, m_index);
+            pos.reset();
+            return pos;
+        }
     private:
+        std::pair<size_t, size_t> accumulated(const size_t time) const {
+            if (m_converter.size() == 0) {
+                return {0, 0};
+            }
+
+            auto [item, start] = m_index.find(time);
+            auto [toggles, high] = m_activity.block_start(item / util::time_index::block_size);
+            auto it = m_converter.at(item);
+            auto previous = *it;
+
+            while (item + 1 < m_converter.size() && start + m_sizes[item] <= time) {
+                high += m_activity.high(previous) ? m_sizes[item] : 0;
+                start += m_sizes[item];
+                item++;
+
+                ++it;
+                toggles += m_activity.toggles(previous, *it);
+                previous = *it;
+            }
+            high += m_activity.high(previous) ? time - start : 0;
+
+            return {toggles, high};
+        }
+
+        void summarize(const std::vector<T>& converted) {
+            if (m_converter.width() <= sizeof(T) * 8) {
+                m_summary.add(converted.empty() ? 0 : converted[0]);
+            }
+        }
+
         util::bits_to_words<T> m_converter;
         std::vector<uint32_t> m_sizes;
+        util::time_index m_index;
+        util::value_summary<T> m_summary;
+        util::activity_index<T> m_activity;
+        util::block_hash m_hash;
         size_t m_current_time = 0;
+        size_t m_active = 0;
 
         std::unique_ptr<wave<T>> m_wave;
     };
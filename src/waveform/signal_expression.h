@@ -0,0 +1,461 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "util/command_line.h"
+#include "signal.h"
+
+namespace wavy::waveform {
+    template<typename T>
+    class signal_expression {
+    public:
+        template<typename F>
+        static std::optional<signal_expression> parse(const std::string& text, F resolve) {
+            signal_expression result;
+            parser<F> p(text, result, resolve);
+
+            auto root = p.parse_expression();
+            if (!root || !p.done()) {
+                return std::nullopt;
+            }
+
+            result.m_root = *root;
+            return result;
+        }
+
+        size_t width() const {
+            return m_nodes[m_root].width;
+        }
+
+        const std::vector<signal<T>*>& operands() const {
+            return m_operands;
+        }
+
+        std::vector<T> evaluate(const std::vector<const std::vector<T>*>& values) const {
+            return evaluate(m_root, values);
+        }
+    private:
+        constexpr static size_t bits = sizeof(T) * 8;
+
+        enum class op {operand, constant, slice, concat, bit_not, logic_not, bit_and, bit_or, bit_xor, eq, ne, lt, le, gt, ge};
+
+        struct node {
+            op kind;
+            size_t width = 1;
+            size_t left = 0;
+            size_t right = 0;
+            size_t low = 0;
+            std::vector<size_t> parts;
+            std::vector<T> constant;
+        };
+
+        static size_t num_words(const size_t width) {
+            return std::max<size_t>(1, (width + bits - 1) / bits);
+        }
+
+        static void truncate(std::vector<T>& words, const size_t width) {
+            words.resize(num_words(width), 0);
+            if (width % bits != 0) {
+                words.back() &= (static_cast<T>(1) << (width % bits)) - 1;
+            }
+        }
+
+        static T bit_range(const std::vector<T>& words, const size_t bit) {
+            auto index = bit / bits;
+            auto offset = bit % bits;
+            T result = index < words.size() ? words[index] >> offset : 0;
+
+            if (offset > 0 && index + 1 < words.size()) {
+                result |= words[index + 1] << (bits - offset);
+            }
+            return result;
+        }
+
+        static int compare(const std::vector<T>& l, const std::vector<T>& r) {
+            for (auto i = std::max(l.size(), r.size()); i > 0; i--) {
+                auto a = i - 1 < l.size() ? l[i - 1] : 0;
+                auto b = i - 1 < r.size() ? r[i - 1] : 0;
+                if (a != b) {
+                    return a < b ? -1 : 1;
+                }
+            }
+            return 0;
+        }
+
+        std::vector<T> evaluate(const size_t n, const std::vector<const std::vector<T>*>& values) const {
+            const auto& current = m_nodes[n];
+
+            switch (current.kind) {
+                case op::operand: {
+                    auto result = *values[current.left];
+                    truncate(result, current.width);
+                    return result;
+                }
+                case op::constant: return current.constant;
+                case op::slice: {
+                    auto source = evaluate(current.left, values);
+                    std::vector<T> result(num_words(current.width));
+                    for (size_t i = 0; i < result.size(); i++) {
+                        result[i] = bit_range(source, current.low + i * bits);
+                    }
+                    truncate(result, current.width);
+                    return result;
+                }
+                case op::concat: {
+                    std::vector<T> result(num_words(current.width), 0);
+                    size_t offset = 0;
+                    for (auto it = current.parts.rbegin(); it != current.parts.rend(); ++it) {
+                        auto part = evaluate(*it, values);
+                        for (size_t i = 0; i < part.size(); i++) {
+                            auto bit = offset + i * bits;
+                            result[bit / bits] |= part[i] << (bit % bits);
+                            if (bit % bits > 0 && bit / bits + 1 < result.size()) {
+                                result[bit / bits + 1] |= part[i] >> (bits - bit % bits);
+                            }
+                        }
+                        offset += m_nodes[*it].width;
+                    }
+                    truncate(result, current.width);
+                    return result;
+                }
+                case op::bit_not: {
+                    auto result = evaluate(current.left, values);
+                    for (auto& w : result) {
+                        w = ~w;
+                    }
+                    truncate(result, current.width);
+                    return result;
+                }
+                case op::logic_not: {
+                    auto operand = evaluate(current.left, values);
+                    return {compare(operand, {}) == 0 ? static_cast<T>(1) : static_cast<T>(0)};
+                }
+                case op::bit_and:
+                case op::bit_or:
+                case op::bit_xor: {
+                    auto result = evaluate(current.left, values);
+                    auto other = evaluate(current.right, values);
+                    result.resize(num_words(current.width), 0);
+                    other.resize(num_words(current.width), 0);
+
+                    for (size_t i = 0; i < result.size(); i++) {
+                        if (current.kind == op::bit_and) {
+                            result[i] &= other[i];
+                        } else if (current.kind == op::bit_or) {
+                            result[i] |= other[i];
+                        } else {
+                            result[i] ^= other[i];
+                        }
+                    }
+                    return result;
+                }
+                default: {
+                    auto c = compare(evaluate(current.left, values), evaluate(current.right, values));
+                    bool matched = false;
+
+                    switch (current.kind) {
+                        case op::eq: matched = c == 0; break;
+                        case op::ne: matched = c != 0; break;
+                        case op::lt: matched = c < 0; break;
+                        case op::le: matched = c <= 0; break;
+                        case op::gt: matched = c > 0; break;
+                        case op::ge: matched = c >= 0; break;
+                        default: break;
+                    }
+                    return {matched ? static_cast<T>(1) : static_cast<T>(0)};
+                }
+            }
+        }
+
+        size_t add_node(node n) {
+            m_nodes.push_back(std::move(n));
+            return m_nodes.size() - 1;
+        }
+
+        template<typename F>
+        class parser {
+        public:
+            parser(const std::string& text, signal_expression& expression, F& resolve) : m_text(text), m_expression(expression), m_resolve(resolve) {}
+
+            bool done() {
+                skip_space();
+                return m_pos == m_text.length();
+            }
+
+            std::optional<size_t> parse_expression() {
+                return parse_binary(0);
+            }
+        private:
+            std::optional<size_t> parse_binary(const size_t level) {
+                if (level == levels.size()) {
+                    return parse_unary();
+                }
+
+                auto left = parse_binary(level + 1);
+                while (left) {
+                    auto kind = match_operator(level);
+                    if (!kind) {
+                        break;
+                    }
+
+                    auto right = parse_binary(level + 1);
+                    if (!right) {
+                        return std::nullopt;
+                    }
+
+                    node n;
+                    n.kind = *kind;
+                    n.left = *left;
+                    n.right = *right;
+                    n.width = level >= 3 ? 1 : std::max(width(*left), width(*right));
+                    left = m_expression.add_node(std::move(n));
+                }
+                return left;
+            }
+
+            std::optional<op> match_operator(const size_t level) {
+                skip_space();
+                for (const auto& [symbol, kind] : levels[level]) {
+                    if (m_text.compare(m_pos, symbol.length(), symbol) == 0) {
+                        auto next = m_pos + symbol.length() < m_text.length() ? m_text[m_pos + symbol.length()] : 0;
+                        if (symbol.length() == 1 && (next == '=' || next == symbol[0])) {
+                            continue;
+                        }
+                        m_pos += symbol.length();
+                        return kind;
+                    }
+                }
+                return std::nullopt;
+            }
+
+            std::optional<size_t> parse_unary() {
+                skip_space();
+                if (m_pos < m_text.length() && (m_text[m_pos] == '~' || m_text[m_pos] == '!')) {
+                    auto kind = m_text[m_pos] == '~' ? op::bit_not : op::logic_not;
+                    m_pos++;
+
+                    auto operand = parse_unary();
+                    if (!operand) {
+                        return std::nullopt;
+                    }
+
+                    node n;
+                    n.kind = kind;
+                    n.left = *operand;
+                    n.width = kind == op::bit_not ? width(*operand) : 1;
+                    return m_expression.add_node(std::move(n));
+                }
+
+                return parse_postfix();
+            }
+
+            std::optional<size_t> parse_postfix() {
+                auto result = parse_primary();
+
+                while (result && accept('[')) {
+                    auto high = parse_index();
+                    auto low = high;
+                    if (accept(':')) {
+                        low = parse_index();
+                    }
+                    if (!high || !low || *low > *high || *high >= width(*result) || !accept(']')) {
+                        return std::nullopt;
+                    }
+
+                    node n;
+                    n.kind = op::slice;
+                    n.left = *result;
+                    n.low = *low;
+                    n.width = *high - *low + 1;
+                    result = m_expression.add_node(std::move(n));
+                }
+
+                return result;
+            }
+
+            std::optional<size_t> parse_primary() {
+                skip_space();
+                if (m_pos == m_text.length()) {
+                    return std::nullopt;
+                }
+
+                if (accept('(')) {
+                    auto result = parse_expression();
+                    if (!result || !accept(')')) {
+                        return std::nullopt;
+                    }
+                    return result;
+                }
+
+                if (accept('{')) {
+                    node n;
+                    n.kind = op::concat;
+                    n.width = 0;
+
+                    do {
+                        auto part = parse_expression();
+                        if (!part) {
+                            return std::nullopt;
+                        }
+                        n.parts.push_back(*part);
+                        n.width += width(*part);
+                    } while (accept(','));
+
+                    if (!accept('}')) {
+                        return std::nullopt;
+                    }
+                    return m_expression.add_node(std::move(n));
+                }
+
+                auto start = m_pos;
+                while (m_pos < m_text.length() && is_word(m_text[m_pos])) {
+                    m_pos++;
+                }
+                auto word = m_text.substr(start, m_pos - start);
+                if (word.empty()) {
+                    return std::nullopt;
+                }
+
+                if (std::isdigit(word[0]) || word[0] == '\'') {
+                    return parse_literal(word);
+                }
+
+                if (auto close = m_text.find(']', m_pos); m_pos < m_text.length() && m_text[m_pos] == '[' && close != std::string::npos) {
+                    auto name = word + m_text.substr(m_pos, close - m_pos + 1);
+                    if (m_resolve(name)) {
+                        word = name;
+                        m_pos = close + 1;
+                    }
+                }
+
+                auto trace = m_resolve(word);
+                if (!trace) {
+                    return std::nullopt;
+                }
+
+                auto& operands = m_expression.m_operands;
+                auto it = std::find(operands.begin(), operands.end(), *trace);
+
+                node n;
+                n.kind = op::operand;
+                n.left = std::distance(operands.begin(), it);
+                n.width = std::max<size_t>(1, (*trace)->width());
+                if (it == operands.end()) {
+                    operands.push_back(*trace);
+                }
+                return m_expression.add_node(std::move(n));
+            }
+
+            std::optional<size_t> parse_literal(const std::string& word) {
+                std::string digits;
+                for (const auto c : word) {
+                    if (c != '_') {
+                        digits += c;
+                    }
+                }
+
+                size_t radix_bits = 0;
+                if (digits.starts_with("0x") || digits.starts_with("'h")) {
+                    radix_bits = 4;
+                } else if (digits.starts_with("0b") || digits.starts_with("'b")) {
+                    radix_bits = 1;
+                }
+
+                node n;
+                n.kind = op::constant;
+
+                if (radix_bits == 0) {
+                    auto value = util::parse_number<T>(digits);
+                    if (!value) {
+                        return std::nullopt;
+                    }
+                    n.constant = {*value};
+                    n.width = std::max<size_t>(1, bits - std::countl_zero(*value));
+                    return m_expression.add_node(std::move(n));
+                }
+
+                digits = digits.substr(2);
+                if (digits.empty()) {
+                    return std::nullopt;
+                }
+
+                n.width = digits.length() * radix_bits;
+                n.constant.assign(num_words(n.width), 0);
+
+                size_t bit = 0;
+                for (auto it = digits.rbegin(); it != digits.rend(); ++it, bit += radix_bits) {
+                    T digit;
+                    if (*it >= '0' && *it <= '9') {
+                        digit = *it - '0';
+                    } else if (*it >= 'a' && *it <= 'f') {
+                        digit = *it - 'a' + 10;
+                    } else if (*it >= 'A' && *it <= 'F') {
+                        digit = *it - 'A' + 10;
+                    } else {
+                        return std::nullopt;
+                    }
+
+                    if (digit >= (static_cast<T>(1) << radix_bits)) {
+                        return std::nullopt;
+                    }
+                    n.constant[bit / bits] |= digit << (bit % bits);
+                }
+                return m_expression.add_node(std::move(n));
+            }
+
+            std::optional<size_t> parse_index() {
+                skip_space();
+                auto start = m_pos;
+                while (m_pos < m_text.length() && std::isdigit(m_text[m_pos])) {
+                    m_pos++;
+                }
+                return util::parse_number<size_t>(m_text.substr(start, m_pos - start));
+            }
+
+            bool accept(const char c) {
+                skip_space();
+                if (m_pos < m_text.length() && m_text[m_pos] == c) {
+                    m_pos++;
+                    return true;
+                }
+                return false;
+            }
+
+            void skip_space() {
+                while (m_pos < m_text.length() && std::isspace(m_text[m_pos])) {
+                    m_pos++;
+                }
+            }
+
+            size_t width(const size_t n) const {
+                return m_expression.m_nodes[n].width;
+            }
+
+            static bool is_word(const char c) {
+                return std::isalnum(c) || c == '_' || c == '.' || c == '$' || c == '\'';
+            }
+
+            inline static const std::vector<std::vector<std::pair<std::string, op>>> levels = {
+                {{"|", op::bit_or}},
+                {{"^", op::bit_xor}},
+                {{"&", op::bit_and}},
+                {{"==", op::eq}, {"!=", op::ne}},
+                {{"<=", op::le}, {">=", op::ge}, {"<", op::lt}, {">", op::gt}}
+            };
+
+            const std::string& m_text;
+            signal_expression& m_expression;
+            F& m_resolve;
+            size_t m_pos = 0;
+        };
+
+        std::vector<node> m_nodes;
+        std::vector<signal<T>*> m_operands;
+        size_t m_root = 0;
+    };
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <deque>
+#include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "import/bus_assembler.h"
+#include "signal.h"
+
+namespace wavy::waveform {
+    template<typename T>
+    class signal_store {
+    public:
+        constexpr static size_t ignored = std::numeric_limits<size_t>::max();
+
+        void set_filter(const std::unordered_set<std::string>& names) {
+            m_filter = names;
+            m_filtered = true;
+        }
+
+        size_t add_signal(const std::string& name, const size_t width) {
+            if (width == 1) {
+                if (auto bit = m_buses.add_bit(name)) {
+                    return *bit;
+                }
+            }
+            return add_node(name, width);
+        }
+
+        void add_transition(const size_t index, const std::string& value, const size_t time) {
+            m_max_time = std::max(m_max_time, time);
+
+            if (index == ignored) {
+                return;
+            }
+
+            if (m_buses.contains(index)) {
+                create_buses();
+                m_buses.add_transition(index, value, time, [this](const size_t bus, const std::vector<T>& words, const size_t at) {
+                    add_words(bus, words, at);
+                });
+            } else {
+                m_signals[index].add_transition(value, time);
+            }
+        }
+
+        void finalize() {
+            create_buses();
+            m_buses.finish([this](const size_t bus, const std::vector<T>& words, const size_t at) {
+                add_words(bus, words, at);
+            });
+        }
+
+        void seal_all() {
+            for (auto& data : m_signals) {
+                data.seal(m_max_time);
+            }
+        }
+
+        size_t size() const {
+            return m_signals.size();
+        }
+
+        const std::string& name(const size_t index) const {
+            return m_names[index];
+        }
+
+        std::optional<size_t> find(const std::string& name) const {
+            if (auto it = m_lookup.find(name); it != m_lookup.end()) {
+                return it->second;
+            }
+            return std::nullopt;
+        }
+
+        signal<T>& data(const size_t index) {
+            return m_signals[index];
+        }
+
+        const signal<T>& data(const size_t index) const {
+            return m_signals[index];
+        }
+
+        size_t max_time() const {
+            return m_max_time;
+        }
+
+        void set_timescale(const std::string& timescale) {
+            m_timescale = timescale;
+        }
+
+        const std::string& timescale() const {
+            return m_timescale;
+        }
+    private:
+        size_t add_node(const std::string& name, const size_t width) {
+            if (m_filtered && !m_filter.contains(name)) {
+                return ignored;
+            }
+
+            m_lookup.emplace(name, m_names.size());
+            m_names.push_back(name);
+            m_signals.emplace_back();
+            m_signals.back().init(width);
+
+            return m_signals.size() - 1;
+        }
+
+        void create_buses() {
+            m_buses.create([this](const std::string& name, const size_t width) {
+                return add_node(name, width);
+            });
+        }
+
+        void add_words(const size_t index, const std::vector<T>& words, const size_t time) {
+            if (index != ignored) {
+                m_signals[index].add_transition(words, time);
+            }
+        }
+
+        std::vector<std::string> m_names;
+        std::unordered_map<std::string, size_t> m_lookup;
+        std::deque<signal<T>> m_signals;
+        std::unordered_set<std::string> m_filter;
+        bool m_filtered = false;
+        size_t m_max_time = 0;
+        std::string m_timescale;
+        import::bus_assembler<T> m_buses;
+    };
+}
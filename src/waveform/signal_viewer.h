@@ -1,57 +1,193 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <queue>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <stdint.h>
 
+#include "util/background_worker.h"
+#include "util/profiler.h"
+
+#include "derived_signal.h"
 #include "signal.h"
+#include "tile_cache.h"
+#include "value_format.h"
 
 namespace wavy::waveform {
     template<typename T>
     class signal_viewer {
     public:
+        struct selected_signal {
+            size_t index;
+            std::string name;
+            signal<T>* data;
+        };
+
+        void set_profiler(util::profiler* profiler) {
+            m_profiler = profiler;
+        }
+
+        size_t cache_hits() const {
+            return m_tiles.hits();
+        }
+
+        size_t cache_misses() const {
+            return m_tiles.misses();
+        }
+
+        size_t frame_memory() const {
+            auto result = m_tiles.memory_usage() + m_frame.capacity();
+            for (const auto& [name, trace] : m_all_frames) {
+                result += name.capacity() + trace.capacity();
+            }
+            for (const auto& [index, data] : m_selected_signals) {
+                result += data.trace->drawn_wave().memory_usage();
+            }
+            return result;
+        }
+
         void set_frame(const size_t columns, const size_t rows) {
+            auto resized = columns != m_columns;
+            auto rows_changed = rows != m_rows;
             m_columns = columns;
             m_rows = rows;
 
+            if (m_cursor_line >= m_start_line + signal_rows()) {
+                m_start_line = m_cursor_line - signal_rows() + 1;
+            }
+
+            if (resized && !m_selected_signals.empty()) {
+                resize_waves();
+                update_all_frames();
+                update_frame();
+            } else if (rows_changed) {
+                update_frame();
+            }
         }
-        void add_signal(const size_t index, const size_t max_time, const std::string& name, signal<T>* data) {
-            m_selected_signals[index].name = name;
-            m_selected_signals[index].trace = data;
-            m_selected_signals[index].pos = m_selected_signals.size() - 1;
 
-            m_selected_signals[index].trace->activate(max_time);
+        void toggle_readout() {
+            m_show_readout = !m_show_readout;
+            update_layout();
+        }
 
-            m_max_name_length = std::max(m_max_name_length, name.length());
-            m_cursor_column = std::max(m_max_name_length, m_cursor_column);
+        bool readout_shown() const {
+            return m_show_readout;
+        }
 
+        void toggle_activity() {
+            m_show_activity = !m_show_activity;
+            update_layout();
+        }
+
+        void set_radix(const radix r) {
+            m_radix = r;
+            update_layout();
+        }
+
+        radix current_radix() const {
+            return m_radix;
+        }
+
+        std::vector<selected_signal> displayed_signals() const {
+            std::vector<selected_signal> result(m_selected_signals.size());
             for (const auto& [index, data] : m_selected_signals) {
-                data.trace->drawn_wave().set_frame(m_columns - m_max_name_length);
+                result[data.pos] = {index, data.name, data.trace};
             }
+            return result;
+        }
 
-            for (const auto& [other_index, align_with_me] : m_selected_signals) {
-                if (other_index != index) {
-                    m_selected_signals[index].trace->drawn_wave().align_with(align_with_me.trace->drawn_wave());
-                    break;
+        void prepare_range(const size_t from, const size_t to) {
+            extend_derived(from, to);
+        }
+        void restore_range() {
+            update_view();
+        }
+        void add_signal(const size_t index, const size_t max_time, const std::string& name, signal<T>* data) {
+            add_signals({{index, name, data}}, max_time);
+        }
+        void add_signals(const std::vector<selected_signal>& signals, const size_t max_time) {
+            m_max_time = std::max(m_max_time, max_time * 1024);
+
+            for (const auto& s : signals) {
+                if (m_selected_signals.contains(s.index)) {
+                    continue;
                 }
+
+                auto& data = m_selected_signals[s.index];
+                data.name = s.name;
+                data.trace = s.data;
+                data.pos = m_selected_signals.size() - 1;
+
+                data.trace->activate(max_time);
+                data.trace->drawn_wave().set_profiler(m_profiler);
+                data.trace->drawn_wave().set_cache(&m_tiles);
+                data.trace->drawn_wave().set_view(m_scale, m_first_column);
+
+                m_max_name_length = std::max(m_max_name_length, s.name.length());
             }
+            m_cursor_column = std::max(m_max_name_length, m_cursor_column);
 
+            resize_waves();
             update_all_frames();
             update_frame();
+            prefetch();
+        }
+        void add_derived(const std::string& name, signal_expression<T>&& expression, const size_t max_time) {
+            remove_derived(name);
+
+            auto index = derived_index + m_derived_counter++;
+            auto& derived = m_derived[index];
+            derived = std::make_unique<derived_signal<T>>(std::move(expression));
+            derived->activate(max_time);
+            extend_derived();
+
+            add_signals({{index, name, &derived->data()}}, max_time);
+        }
+        bool remove_derived(const std::string& name) {
+            for (const auto& [index, derived] : m_derived) {
+                if (m_selected_signals.at(index).name == name) {
+                    auto removed = index;
+                    remove_signals({removed});
+                    m_derived.erase(removed);
+                    return true;
+                }
+            }
+            return false;
         }
         void remove_signal(const size_t index) {
-            auto pos = m_selected_signals[index].pos;
-            for (auto& [index, data] : m_selected_signals) {
-                if (data.pos > pos) {
-                    data.pos--;
+            remove_signals({index});
+        }
+        void remove_signals(const std::vector<size_t>& indices) {
+            m_prefetcher.cancel();
+
+            for (const auto index : indices) {
+                if (auto it = m_selected_signals.find(index); it != m_selected_signals.end()) {
+                    it->second.trace->deactivate();
+                    m_selected_signals.erase(it);
                 }
             }
-            m_selected_signals[index].trace->deactivate();
-            m_selected_signals.erase(index);
 
+            std::vector<signal_data*> remaining;
+            for (auto& [index, data] : m_selected_signals) {
+                remaining.push_back(&data);
+            }
+            std::sort(remaining.begin(), remaining.end(), [](const signal_data* l, const signal_data* r) {
+                return l->pos < r->pos;
+            });
+            for (size_t i = 0; i < remaining.size(); i++) {
+                remaining[i]->pos = i;
+            }
+
+            resize_waves();
             update_all_frames();
             update_frame();
+            prefetch();
         }
         
         const std::string& frame() const {
@@ -87,81 +223,556 @@ namespace wavy::waveform {
             }
         }
 
-        void move_up() {
-            if (m_cursor_line > 0) {
-                if (m_cursor_line == m_start_line) {
-                    m_start_line--;
-                }
-                m_cursor_line--;
+        void move_up(const size_t n = 1) {
+            auto steps = std::min(n, m_cursor_line);
+
+            if (steps > 0) {
+                m_cursor_line -= steps;
+                m_start_line = std::min(m_start_line, m_cursor_line);
                 update_frame();
             }
         }
 
-        void move_down() {
-            if (m_cursor_line == m_start_line + m_rows - 1) {
-                m_start_line++;
+        void move_down(const size_t n = 1) {
+            m_cursor_line += n;
+            if (m_cursor_line >= m_start_line + signal_rows()) {
+                m_start_line = m_cursor_line - signal_rows() + 1;
             }
-            m_cursor_line++;
             update_frame();
         }
 
-        void move_left() {
-            if (m_cursor_column > m_max_name_length) {
-                m_cursor_column--;
+        void move_left(const size_t n = 1) {
+            m_exact_time = std::nullopt;
+            auto steps = std::min(n, m_cursor_column - m_max_name_length);
+            m_cursor_column -= steps;
+
+            if (steps < n) {
+                m_first_column -= std::min(m_first_column, n - steps);
+                update_view();
             } else {
-                for (auto& [index, data] : m_selected_signals) {
-                    data.trace->drawn_wave().scroll_right(1);
+                update_frame();
+            }
+        }
+
+        void move_right(const size_t n = 1) {
+            m_exact_time = std::nullopt;
+            auto last = m_max_name_length + std::max<size_t>(wave_columns(), 1) - 1;
+            auto steps = std::min(n, last - std::min(last, m_cursor_column));
+            m_cursor_column += steps;
+
+            if (steps < n) {
+                m_first_column += n - steps;
+                update_view();
+            } else {
+                update_frame();
+            }
+        }
+
+        void zoom_in(const size_t n = 1) {
+            auto scale = m_scale;
+            for (size_t i = 0; i < n && scale > 1; i++) {
+                scale /= 2;
+            }
+            set_scale(scale);
+        }
+
+        void zoom_out(const size_t n = 1) {
+            auto scale = m_scale;
+            for (size_t i = 0; i < n && scale < max_scale; i++) {
+                scale *= 2;
+            }
+            set_scale(scale);
+        }
+
+        void set_scale(const size_t scale) {
+            auto offset = cursor_offset();
+            auto time = cursor_time();
+
+            m_exact_time = std::nullopt;
+            m_scale = std::clamp<size_t>(scale, 1, max_scale);
+            m_first_column = time / m_scale - std::min(time / m_scale, offset);
+            m_cursor_column = m_max_name_length + time / m_scale - m_first_column;
+
+            update_view();
+        }
+
+        void goto_time(const size_t time) {
+            auto column = time / m_scale;
+            auto center = wave_columns() / 2;
+
+            m_exact_time = std::nullopt;
+            m_first_column = column - std::min(column, center);
+            m_cursor_column = m_max_name_length + column - m_first_column;
+
+            update_view();
+        }
+
+        void fit(const size_t from, const size_t to) {
+            auto columns = std::max<size_t>(wave_columns(), 3) - 2;
+            auto duration = std::max<size_t>(to, from + 1) - from;
+
+            m_exact_time = std::nullopt;
+            m_scale = std::clamp<size_t>((duration + columns - 1) / columns, 1, max_scale);
+            m_first_column = from / m_scale;
+            m_cursor_column = m_max_name_length;
+
+            update_view();
+        }
+
+        void fit() {
+            fit(0, m_max_time);
+        }
+
+        void next_transition(const size_t n = 1) {
+            extend_derived(cursor_time(), m_max_time);
+
+            if (auto trace = cursor_signal()) {
+                auto time = cursor_time();
+                bool found = false;
+
+                for (size_t i = 0; i < n; i++) {
+                    if (auto next = (*trace)->next_transition(time)) {
+                        time = *next;
+                        found = true;
+                    } else {
+                        break;
+                    }
+                }
+
+                if (found) {
+                    set_cursor_time(time);
                 }
-                update_all_frames();
             }
+        }
 
-            update_frame();
+        void previous_transition(const size_t n = 1) {
+            extend_derived(0, cursor_time());
+
+            if (auto trace = cursor_signal(); trace && cursor_time() >= m_scale) {
+                auto limit = cursor_time() - m_scale;
+                std::optional<size_t> found;
+
+                for (size_t i = 0; i < n; i++) {
+                    if (auto previous = (*trace)->previous_transition(limit)) {
+                        found = previous;
+                        if (*previous == 0) {
+                            break;
+                        }
+                        limit = *previous - 1;
+                    } else {
+                        break;
+                    }
+                }
+
+                if (found) {
+                    set_cursor_time(*found);
+                }
+            }
         }
 
-        void move_right() {
-            if (m_cursor_column == m_columns - 1) {
-                for (auto& [index, data] : m_selected_signals) {
-                    data.trace->drawn_wave().scroll_left(1);
+        void next_event(const size_t n = 1) {
+            extend_derived(cursor_time(), m_max_time);
+
+            std::vector<wave_position<T>> positions;
+            std::priority_queue<std::pair<size_t, size_t>, std::vector<std::pair<size_t, size_t>>, std::greater<>> events;
+            auto time = cursor_time();
+
+            positions.reserve(m_selected_signals.size());
+            for (const auto& [index, data] : m_selected_signals) {
+                auto pos = data.trace->position();
+                pos.seek(time);
+
+                if (pos.next_change()) {
+                    events.push({pos.time(), positions.size()});
+                    positions.push_back(pos);
                 }
-                update_all_frames();
+            }
+
+            if (auto target = merge_events(positions, events, n, [](wave_position<T>& pos) {
+                return pos.next_change();
+            })) {
+                set_cursor_time(*target);
+            }
+        }
+
+        void previous_event(const size_t n = 1) {
+            if (cursor_time() < m_scale) {
+                return;
+            }
+
+            extend_derived(0, cursor_time());
+
+            std::vector<wave_position<T>> positions;
+            std::priority_queue<std::pair<size_t, size_t>> events;
+            auto limit = cursor_time() - m_scale;
+
+            positions.reserve(m_selected_signals.size());
+            for (const auto& [index, data] : m_selected_signals) {
+                auto pos = data.trace->position();
+                pos.seek(limit);
+
+                if (pos.run_start()) {
+                    events.push({pos.time(), positions.size()});
+                    positions.push_back(pos);
+                }
+            }
+
+            if (auto target = merge_events(positions, events, n, [](wave_position<T>& pos) {
+                return pos.move_left() && pos.run_start();
+            })) {
+                set_cursor_time(*target);
+            }
+        }
+
+        bool find_value(const std::string& expression) {
+            extend_derived(cursor_time(), m_max_time);
+
+            if (auto trace = cursor_signal()) {
+                if (auto filter = value_filter<T>::parse(expression, (*trace)->width())) {
+                    if (auto time = (*trace)->find_value(*filter, cursor_time())) {
+                        set_cursor_time(*time);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        void set_cursor_time(const size_t time) {
+            auto column = (time + m_scale - 1) / m_scale;
+
+            if (column >= m_first_column && column < m_first_column + wave_columns()) {
+                m_cursor_column = m_max_name_length + column - m_first_column;
+                update_frame();
             } else {
-                m_cursor_column++;
+                goto_time(column * m_scale);
+            }
+            m_exact_time = time;
+        }
+
+        size_t cursor_time() const {
+            return (m_first_column + cursor_offset()) * m_scale;
+        }
+
+        size_t exact_cursor_time() const {
+            if (m_exact_time && (*m_exact_time + m_scale - 1) / m_scale == m_first_column + cursor_offset()) {
+                return *m_exact_time;
+            }
+            return cursor_time();
+        }
+
+        std::string set_marker(const std::string& name = "") {
+            auto marker = name;
+            if (marker.empty()) {
+                do {
+                    marker = "m" + std::to_string(++m_marker_counter);
+                } while (m_markers.contains(marker));
+            }
+
+            auto rows = signal_rows();
+            m_markers[marker] = exact_cursor_time();
+            if (m_measured.second != marker) {
+                m_measured = {m_measured.second, marker};
+            }
+
+            update_marker_rows(rows);
+            return marker;
+        }
+
+        void remove_marker(const std::string& name) {
+            auto rows = signal_rows();
+            m_markers.erase(name);
+            update_marker_rows(rows);
+        }
+
+        void clear_markers() {
+            auto rows = signal_rows();
+            m_markers.clear();
+            m_measured = {};
+            update_marker_rows(rows);
+        }
+
+        std::optional<size_t> marker_time(const std::string& name) const {
+            if (auto it = m_markers.find(name); it != m_markers.end()) {
+                return it->second;
             }
+            return std::nullopt;
+        }
+
+        bool measure(const std::string& from, const std::string& to) {
+            if (!m_markers.contains(from) || !m_markers.contains(to)) {
+                return false;
+            }
+
+            m_measured = {from, to};
             update_frame();
+            return true;
         }
 
-        void zoom_in() {
-            auto delta = m_cursor_column - m_max_name_length;
+        void next_marker(const size_t n = 1) {
+            auto time = cursor_time();
+            std::vector<size_t> times;
+            for (const auto& [name, marker] : m_markers) {
+                if (marker > time) {
+                    times.push_back(marker);
+                }
+            }
 
-            for (auto& [index, data] : m_selected_signals) {
-                data.trace->drawn_wave().scroll_left(delta);
-                data.trace->drawn_wave().zoom_in();
-                data.trace->drawn_wave().scroll_right(delta);
+            if (!times.empty()) {
+                std::sort(times.begin(), times.end());
+                set_cursor_time(times[std::min(n, times.size()) - 1]);
+            }
+        }
+
+        void previous_marker(const size_t n = 1) {
+            auto time = cursor_time();
+            std::vector<size_t> times;
+            for (const auto& [name, marker] : m_markers) {
+                if ((marker + m_scale - 1) / m_scale * m_scale < time) {
+                    times.push_back(marker);
+                }
             }
 
+            if (!times.empty()) {
+                std::sort(times.begin(), times.end(), std::greater<>());
+                set_cursor_time(times[std::min(n, times.size()) - 1]);
+            }
+        }
+    private:
+        constexpr static size_t max_scale = 1UL << 48;
+        constexpr static size_t derived_index = 1UL << 63;
+        constexpr static size_t heat_cells = 8;
+
+        size_t signal_rows() const {
+            auto markers = m_markers.empty() ? 0 : 1;
+            return std::max<size_t>(m_rows, markers + 1) - markers;
+        }
+
+        void update_marker_rows(const size_t rows) {
+            if (rows != signal_rows() && m_cursor_line >= m_start_line + signal_rows()) {
+                m_start_line = m_cursor_line - signal_rows() + 1;
+            }
+            update_frame();
+        }
+
+        std::string marker_row() const {
+            std::string delta;
+            const auto& [from, to] = m_measured;
+            auto from_time = marker_time(from);
+            auto to_time = marker_time(to);
+
+            if (from_time && to_time) {
+                delta = to + "-" + from + "=" + (*to_time < *from_time ? "-" : "") + format_time(std::max(*from_time, *to_time) - std::min(*from_time, *to_time)) + " ";
+            }
+            if (delta.length() > m_max_name_length) {
+                delta = delta.substr(delta.length() - m_max_name_length);
+            }
+
+            auto s = std::string(m_max_name_length - delta.length(), ' ') + delta + std::string(wave_columns(), ' ');
+            for (const auto& [name, time] : m_markers) {
+                auto column = (time + m_scale - 1) / m_scale;
+                if (column >= m_first_column && column < m_first_column + wave_columns()) {
+                    auto offset = m_max_name_length + column - m_first_column;
+                    auto label = ("|" + name).substr(0, s.length() - offset);
+                    s.replace(offset, label.length(), label);
+                }
+            }
+            s.resize(m_columns, ' ');
+
+            return cmd::add_style<cmd::styles::font::bold, cmd::styles::colors::background::extended<236>, cmd::styles::colors::foreground::extended<214>>(s) + "\n";
+        }
+
+        size_t view_columns() const {
+            return m_columns - std::min(m_columns, m_readout_columns + m_heat_columns);
+        }
+
+        size_t wave_columns() const {
+            return view_columns() - std::min(view_columns(), m_max_name_length);
+        }
+
+        size_t readout_columns() const {
+            if (!m_show_readout) {
+                return 0;
+            }
+
+            size_t digits = 1;
+            for (const auto& [index, data] : m_selected_signals) {
+                digits = std::max(digits, value_digits(data.trace->width(), m_radix));
+            }
+            return std::min(digits + 2, m_columns / 3);
+        }
+
+        void resize_waves() {
+            m_readout_columns = readout_columns();
+            auto heat_columns = std::min(heat_cells + 1, m_columns / 3);
+            m_heat_columns = m_show_activity && heat_columns > 1 ? heat_columns : 0;
+            extend_derived();
+
+            for (const auto& [index, data] : m_selected_signals) {
+                data.trace->drawn_wave().set_frame(wave_columns());
+            }
+        }
+
+        void update_layout() {
+            resize_waves();
+
+            auto last = m_max_name_length + std::max<size_t>(wave_columns(), 1) - 1;
+            m_cursor_column = std::min(m_cursor_column, last);
+
             update_all_frames();
             update_frame();
+            prefetch();
+        }
+
+        std::string readout(const signal<T>* trace, const size_t time) const {
+            auto pos = trace->position();
+            pos.seek(time);
+
+            auto text = format_value(pos.words(), trace->width(), m_radix);
+            auto room = m_readout_columns - std::min<size_t>(m_readout_columns, 2);
+            if (text.length() > room) {
+                auto dots = std::min<size_t>(2, room);
+                text = std::string(dots, '.') + text.substr(text.length() - (room - dots));
+            }
+
+            return " " + text + std::string(m_readout_columns - 1 - text.length(), ' ');
+        }
+
+        size_t cursor_offset() const {
+            return m_cursor_column - std::min(m_cursor_column, m_max_name_length);
+        }
+
+        template<typename Q, typename F>
+        std::optional<size_t> merge_events(std::vector<wave_position<T>>& positions, Q& events, const size_t n, F advance) const {
+            std::optional<size_t> result;
+
+            for (size_t i = 0; i < n && !events.empty(); i++) {
+                auto time = events.top().first;
+
+                while (!events.empty() && events.top().first == time) {
+                    auto index = events.top().second;
+                    events.pop();
+
+                    if (advance(positions[index])) {
+                        events.push({positions[index].time(), index});
+                    }
+                }
+                result = time;
+            }
+
+            return result;
         }
 
-        void zoom_out() {
-            auto delta = m_cursor_column - m_max_name_length;
+        std::optional<signal<T>*> cursor_signal() const {
+            for (const auto& [index, data] : m_selected_signals) {
+                if (data.pos == m_cursor_line) {
+                    return data.trace;
+                }
+            }
+            return std::nullopt;
+        }
+
+        void extend_derived() {
+            auto margin = (wave_columns() + 4 * tile_cache::tile_columns) * m_scale;
+            auto from = m_first_column * m_scale;
+            auto to = from + wave_columns() * m_scale;
+
+            extend_derived(from - std::min(from, margin), to + margin, margin);
+        }
+
+        void extend_derived(const size_t from, const size_t to, const size_t padding = 0) {
+            bool cancelled = false;
+
+            for (auto& [index, derived] : m_derived) {
+                if (!derived->covers(from, to)) {
+                    if (!cancelled) {
+                        m_prefetcher.cancel();
+                        cancelled = true;
+                    }
+
+                    derived->ensure(from - std::min(from, padding), to + padding);
+                    if (m_selected_signals.contains(index)) {
+                        derived->data().drawn_wave().invalidate();
+                    }
+                }
+            }
+        }
+
+        void update_view() {
+            extend_derived();
 
             for (auto& [index, data] : m_selected_signals) {
-                data.trace->drawn_wave().scroll_left(delta);
-                data.trace->drawn_wave().zoom_out();
-                data.trace->drawn_wave().scroll_right(delta);
+                data.trace->drawn_wave().set_view(m_scale, m_first_column);
             }
 
             update_all_frames();
             update_frame();
+            prefetch();
         }
-    private:
+
+        void prefetch() {
+            std::deque<std::function<void()>> jobs;
+            std::vector<std::pair<const wave<T>*, std::vector<std::pair<size_t, size_t>>>> tiles;
+
+            for (const auto& [index, data] : m_selected_signals) {
+                const auto* wave = &data.trace->drawn_wave();
+                tiles.push_back({wave, wave->prefetch_tiles()});
+            }
+
+            for (size_t rank = 0, added = 1; added > 0; rank++) {
+                added = 0;
+                for (const auto& [wave, wave_tiles] : tiles) {
+                    if (rank < wave_tiles.size()) {
+                        auto [scale, tile] = wave_tiles[rank];
+                        jobs.push_back([wave, scale, tile]() {
+                            wave->prefetch(scale, tile);
+                        });
+                        added++;
+                    }
+                }
+            }
+
+            m_prefetcher.replace_jobs(std::move(jobs));
+        }
+
         void update_all_frames() {
             m_all_frames.resize(m_selected_signals.size());
 
             for (const auto& [index, data] : m_selected_signals) {
                 m_all_frames[data.pos] = {data.name, data.trace->drawn_wave().frame()};
             }
+            update_heat_strips();
+        }
+
+        void update_heat_strips() {
+            m_heat_strips.clear();
+            if (m_heat_columns == 0) {
+                return;
+            }
+
+            auto cells = m_heat_columns - 1;
+            auto from = m_first_column * m_scale;
+            auto slice = std::max<size_t>(wave_columns() * m_scale / cells, 1);
+            std::vector<size_t> toggles(m_selected_signals.size() * cells);
+            size_t max = 0;
+
+            for (const auto& [index, data] : m_selected_signals) {
+                for (size_t i = 0; i < cells; i++) {
+                    auto start = std::min(from + i * slice, m_max_time) / 1024;
+                    auto end = std::min(from + (i + 1) * slice, m_max_time) / 1024;
+                    auto& count = toggles[data.pos * cells + i];
+
+                    count = data.trace->activity(start, end).toggles;
+                    max = std::max(max, count);
+                }
+            }
+
+            const char* levels[] = {" ", "░", "▒", "▓", "█"};
+            m_heat_strips.resize(m_selected_signals.size(), " ");
+            for (size_t i = 0; i < toggles.size(); i++) {
+                auto level = toggles[i] == 0 ? 0 : std::min<size_t>(1 + 3 * toggles[i] / max, 4);
+                m_heat_strips[i / cells] += levels[level];
+            }
         }
         std::string add_style_to_line(const std::string& s, const size_t line) const {
             if (line == m_cursor_line) {
@@ -183,6 +794,13 @@ namespace wavy::waveform {
                 }
             }
         }
+        std::string add_panel_style(const std::string& s, const size_t line) const {
+            if (line == m_cursor_line) {
+                return cmd::add_style<cmd::styles::font::bold, cmd::styles::colors::background::extended<236>, cmd::styles::colors::foreground::extended<214>>(s);
+            } else {
+                return cmd::add_style<cmd::styles::colors::background::extended<236>, cmd::styles::colors::foreground::extended<15>>(s);
+            }
+        }
         std::string replace_bit_symbols(const std::string& s) const {
             std::string result;
             result.reserve(s.length());
@@ -197,20 +815,48 @@ namespace wavy::waveform {
             return result;
         }
         void update_frame() {
+            util::profiler::timer timer(m_profiler, &util::profiler::frame_counters::style_us);
             m_frame = "";
 
-            for (auto line = m_start_line; line < std::min(m_all_frames.size(), m_start_line + m_rows); line++) {
+            std::vector<const signal<T>*> traces;
+            if (m_readout_columns > 0) {
+                traces.resize(m_all_frames.size());
+                for (const auto& [index, data] : m_selected_signals) {
+                    traces[data.pos] = data.trace;
+                }
+            }
+            auto time = exact_cursor_time();
+
+            if (!m_markers.empty()) {
+                m_frame += marker_row();
+            }
+
+            for (auto line = m_start_line; line < std::min(m_all_frames.size(), m_start_line + signal_rows()); line++) {
                 const auto& [name, trace] = m_all_frames[line];
                 auto s = std::string(m_max_name_length - name.length(), ' ') + name + trace;
-                s = s.substr(0, std::min(m_columns, s.length()));
-                s += std::string(m_columns - s.length(), ' ');
+                s = s.substr(0, std::min(view_columns(), s.length()));
+                s += std::string(view_columns() - s.length(), ' ');
 
-                m_frame += replace_bit_symbols(add_style_to_line(s, line)) + "\n";
+                m_frame += replace_bit_symbols(add_style_to_line(s, line));
+                if (m_heat_columns > 0) {
+                    m_frame += add_panel_style(m_heat_strips[line], line);
+                }
+                if (m_readout_columns > 0) {
+                    m_frame += add_panel_style(readout(traces[line], time), line);
+                }
+                m_frame += "\n";
             }
-            for (auto line = std::min(m_all_frames.size(), m_start_line + m_rows); line < m_start_line + m_rows; line++) {
-                auto s = std::string(m_columns, ' ') + "\n";
+            for (auto line = std::min(m_all_frames.size(), m_start_line + signal_rows()); line < m_start_line + signal_rows(); line++) {
+                auto s = std::string(view_columns(), ' ');
 
                 m_frame += add_style_to_line(s, line);
+                if (m_heat_columns > 0) {
+                    m_frame += add_panel_style(std::string(m_heat_columns, ' '), line);
+                }
+                if (m_readout_columns > 0) {
+                    m_frame += add_panel_style(std::string(m_readout_columns, ' '), line);
+                }
+                m_frame += "\n";
             }
         }
 
@@ -223,13 +869,37 @@ namespace wavy::waveform {
         std::unordered_map<size_t, signal_data> m_selected_signals;
         std::vector<std::pair<std::string, std::string>> m_all_frames;
 
-        size_t m_columns;
-        size_t m_rows;
+        size_t m_columns = 0;
+        size_t m_rows = 0;
         size_t m_max_name_length = 0;
         std::string m_frame;
         size_t m_start_line = 0;
         size_t m_cursor_line = 0;
 
         size_t m_cursor_column = 0;
+        std::optional<size_t> m_exact_time;
+
+        size_t m_scale = 1024;
+        size_t m_first_column = 0;
+        size_t m_max_time = 0;
+
+        bool m_show_readout = false;
+        radix m_radix = radix::hex;
+        size_t m_readout_columns = 0;
+
+        bool m_show_activity = false;
+        size_t m_heat_columns = 0;
+        std::vector<std::string> m_heat_strips;
+
+        std::map<std::string, size_t> m_markers;
+        std::pair<std::string, std::string> m_measured;
+        size_t m_marker_counter = 0;
+
+        std::unordered_map<size_t, std::unique_ptr<derived_signal<T>>> m_derived;
+        size_t m_derived_counter = 0;
+
+        util::profiler* m_profiler = nullptr;
+        tile_cache m_tiles;
+        util::background_worker m_prefetcher;
     };
 }
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace wavy::waveform {
+    class tile_cache {
+    public:
+        constexpr static size_t tile_columns = 128;
+
+        struct key {
+            const void* signal;
+            size_t scale;
+            size_t tile;
+
+            bool operator==(const key& other) const {
+                return signal == other.signal && scale == other.scale && tile == other.tile;
+            }
+        };
+
+        tile_cache(const size_t capacity = 8192) : m_capacity(capacity) {}
+
+        std::optional<std::string> get(const key& k) {
+            std::unique_lock ul(m_mutex);
+
+            auto it = m_lookup.find(k);
+            if (it == m_lookup.end()) {
+                m_misses++;
+                return std::nullopt;
+            }
+
+            m_hits++;
+            m_tiles.splice(m_tiles.begin(), m_tiles, it->second);
+            return it->second->second;
+        }
+
+        bool contains(const key& k) const {
+            std::unique_lock ul(m_mutex);
+            return m_lookup.contains(k);
+        }
+
+        void put(const key& k, const std::string& tile) {
+            std::unique_lock ul(m_mutex);
+
+            auto it = m_lookup.find(k);
+            if (it != m_lookup.end()) {
+                m_bytes = m_bytes - it->second->second.capacity() + tile.capacity();
+                it->second->second = tile;
+                m_tiles.splice(m_tiles.begin(), m_tiles, it->second);
+                return;
+            }
+
+            m_tiles.emplace_front(k, tile);
+            m_lookup[k] = m_tiles.begin();
+            m_bytes += m_tiles.front().second.capacity();
+
+            while (m_tiles.size() > m_capacity) {
+                m_bytes -= m_tiles.back().second.capacity();
+                m_lookup.erase(m_tiles.back().first);
+                m_tiles.pop_back();
+            }
+        }
+
+        void erase(const void* signal) {
+            std::unique_lock ul(m_mutex);
+
+            for (auto it = m_tiles.begin(); it != m_tiles.end();) {
+                if (it->first.signal == signal) {
+                    m_bytes -= it->second.capacity();
+                    m_lookup.erase(it->first);
+                    it = m_tiles.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        size_t hits() const {
+            std::unique_lock ul(m_mutex);
+            return m_hits;
+        }
+
+        size_t misses() const {
+            std::unique_lock ul(m_mutex);
+            return m_misses;
+        }
+
+        size_t memory_usage() const {
+            std::unique_lock ul(m_mutex);
+            return m_bytes;
+        }
+    private:
+        struct key_hash {
+            size_t operator()(const key& k) const {
+                auto h = std::hash<const void*>()(k.signal);
+                h ^= std::hash<size_t>()(k.scale) + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2);
+                h ^= std::hash<size_t>()(k.tile) + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2);
+                return h;
+            }
+        };
+
+        mutable std::mutex m_mutex;
+        std::list<std::pair<key, std::string>> m_tiles;
+        std::unordered_map<key, std::list<std::pair<key, std::string>>::iterator, key_hash> m_lookup;
+        size_t m_capacity;
+        size_t m_hits = 0;
+        size_t m_misses = 0;
+        size_t m_bytes = 0;
+    };
+}
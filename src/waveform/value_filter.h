@@ -0,0 +1,243 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "util/command_line.h"
+#include "util/value_summary.h"
+
+namespace wavy::waveform {
+    template<typename T>
+    class value_filter {
+    public:
+        static std::optional<value_filter> parse(const std::string& expression, const size_t width) {
+            auto tokens = tokenize(expression);
+            value_filter result;
+            size_t i = 0;
+
+            result.m_num_words = std::max<size_t>(1, (width + bits - 1) / bits);
+            result.m_mask.assign(result.m_num_words, ~static_cast<T>(0));
+
+            if (i + 1 < tokens.size() && tokens[i] == "&") {
+                auto mask = result.parse_literal(tokens[i + 1]);
+                if (!mask) {
+                    return std::nullopt;
+                }
+                result.m_mask = *mask;
+                i += 2;
+            }
+
+            if (i + 1 == tokens.size()) {
+                auto separator = tokens[i].find("..");
+
+                if (separator != std::string::npos) {
+                    auto lower = result.parse_literal(tokens[i].substr(0, separator));
+                    auto upper = result.parse_literal(tokens[i].substr(separator + 2));
+                    if (!lower || !upper) {
+                        return std::nullopt;
+                    }
+
+                    result.m_op = op::range;
+                    result.m_value = *lower;
+                    result.m_upper = *upper;
+                    return result;
+                }
+
+                if (auto value = result.parse_literal(tokens[i])) {
+                    result.m_op = op::eq;
+                    result.m_value = *value;
+                    return result;
+                }
+            }
+
+            if (i + 2 == tokens.size()) {
+                auto value = result.parse_literal(tokens[i + 1]);
+                auto compare = parse_op(tokens[i]);
+                if (!value || !compare) {
+                    return std::nullopt;
+                }
+
+                result.m_op = *compare;
+                result.m_value = *value;
+                return result;
+            }
+
+            return std::nullopt;
+        }
+
+        bool matches(const std::vector<T>& words) const {
+            auto c = compare(words, m_value);
+
+            switch (m_op) {
+                case op::eq: return c == 0;
+                case op::ne: return c != 0;
+                case op::lt: return c < 0;
+                case op::le: return c <= 0;
+                case op::gt: return c > 0;
+                case op::ge: return c >= 0;
+                case op::range: return c >= 0 && compare(words, m_upper) <= 0;
+                default: return false;
+            }
+        }
+
+        bool may_match(const typename util::value_summary<T>::block& b) const {
+            if (m_num_words != 1) {
+                return true;
+            }
+
+            auto mask = m_mask[0];
+            auto value = m_value[0];
+            T low = b.all_set & mask;
+            T high = b.any_set & mask;
+
+            if (mask == ~static_cast<T>(0)) {
+                low = std::max(low, b.min);
+                high = std::min(high, b.max);
+            }
+
+            switch (m_op) {
+                case op::eq: return (value & ~(b.any_set & mask)) == 0 && ((b.all_set & mask) & ~value) == 0 && low <= value && value <= high;
+                case op::ne: return low != high || low != value;
+                case op::lt: return low < value;
+                case op::le: return low <= value;
+                case op::gt: return high > value;
+                case op::ge: return high >= value;
+                case op::range: return high >= value && low <= m_upper[0];
+                default: return true;
+            }
+        }
+    private:
+        constexpr static size_t bits = sizeof(T) * 8;
+
+        enum class op {eq, ne, lt, le, gt, ge, range};
+
+        static std::vector<std::string> tokenize(const std::string& expression) {
+            std::vector<std::string> result;
+
+            for (const auto& word : util::split_by_space(expression)) {
+                size_t i = 0;
+                while (i < word.length()) {
+                    auto start = i;
+                    if (is_operator(word[i])) {
+                        while (i < word.length() && is_operator(word[i])) {
+                            i++;
+                        }
+                    } else {
+                        while (i < word.length() && !is_operator(word[i])) {
+                            i++;
+                        }
+                    }
+                    result.push_back(word.substr(start, i - start));
+                }
+            }
+
+            return result;
+        }
+
+        static bool is_operator(const char c) {
+            return c == '=' || c == '!' || c == '<' || c == '>' || c == '&';
+        }
+
+        static std::optional<op> parse_op(const std::string& s) {
+            if (s == "==" || s == "=") {
+                return op::eq;
+            }
+            if (s == "!=") {
+                return op::ne;
+            }
+            if (s == "<") {
+                return op::lt;
+            }
+            if (s == "<=") {
+                return op::le;
+            }
+            if (s == ">") {
+                return op::gt;
+            }
+            if (s == ">=") {
+                return op::ge;
+            }
+            return std::nullopt;
+        }
+
+        std::optional<std::vector<T>> parse_literal(const std::string& token) const {
+            std::string digits;
+            for (const auto c : token) {
+                if (c != '_') {
+                    digits += c;
+                }
+            }
+
+            size_t radix_bits = 0;
+            if (digits.starts_with("0x") || digits.starts_with("'h")) {
+                radix_bits = 4;
+            } else if (digits.starts_with("0b") || digits.starts_with("'b")) {
+                radix_bits = 1;
+            }
+
+            std::vector<T> result(m_num_words, 0);
+
+            if (radix_bits == 0) {
+                auto value = util::parse_number<T>(digits);
+                if (!value) {
+                    return std::nullopt;
+                }
+                result[0] = *value;
+                return result;
+            }
+
+            digits = digits.substr(2);
+            if (digits.empty()) {
+                return std::nullopt;
+            }
+
+            size_t bit = 0;
+            for (auto it = digits.rbegin(); it != digits.rend(); ++it, bit += radix_bits) {
+                T digit;
+                if (*it >= '0' && *it <= '9') {
+                    digit = *it - '0';
+                } else if (*it >= 'a' && *it <= 'f') {
+                    digit = *it - 'a' + 10;
+                } else if (*it >= 'A' && *it <= 'F') {
+                    digit = *it - 'A' + 10;
+                } else {
+                    return std::nullopt;
+                }
+
+                if (digit >= (static_cast<T>(1) << radix_bits)) {
+                    return std::nullopt;
+                }
+                if (digit == 0) {
+                    continue;
+                }
+                if (bit / bits >= m_num_words) {
+                    return std::nullopt;
+                }
+                result[bit / bits] |= digit << (bit % bits);
+            }
+
+            return result;
+        }
+
+        int compare(const std::vector<T>& words, const std::vector<T>& reference) const {
+            for (size_t i = m_num_words; i > 0; i--) {
+                auto word = i - 1 < words.size() ? words[i - 1] & m_mask[i - 1] : 0;
+
+                if (word < reference[i - 1]) {
+                    return -1;
+                }
+                if (word > reference[i - 1]) {
+                    return 1;
+                }
+            }
+            return 0;
+        }
+
+        op m_op = op::eq;
+        size_t m_num_words = 1;
+        std::vector<T> m_mask;
+        std::vector<T> m_value;
+        std::vector<T> m_upper;
+    };
+}
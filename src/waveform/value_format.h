@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace wavy::waveform {
+    enum class radix {bin, dec, hex};
+
+    inline std::optional<radix> parse_radix(const std::string& name) {
+        if (name == "bin" || name == "b") {
+            return radix::bin;
+        }
+        if (name == "dec" || name == "d") {
+            return radix::dec;
+        }
+        if (name == "hex" || name == "h") {
+            return radix::hex;
+        }
+        return std::nullopt;
+    }
+
+    inline size_t value_digits(const size_t width, const radix r) {
+        switch (r) {
+            case radix::bin: return std::max<size_t>(width, 1);
+            case radix::dec: return width * 30103 / 100000 + 1;
+            case radix::hex: return std::max<size_t>((width + 3) / 4, 1);
+            default: return 1;
+        }
+    }
+
+    inline std::string format_time(const size_t time) {
+        auto result = std::to_string(time / 1024);
+
+        if (auto fraction = time % 1024; fraction > 0) {
+            std::stringstream sstream;
+            sstream << std::fixed << std::setprecision(10) << fraction / 1024.0;
+            auto digits = sstream.str().substr(1);
+            digits.erase(digits.find_last_not_of('0') + 1);
+            result += digits;
+        }
+        return result;
+    }
+
+    template<typename T>
+    std::string format_value(const std::vector<T>& words, const size_t width, const radix r) {
+        constexpr size_t bits = sizeof(T) * 8;
+        std::string result;
+
+        if (r == radix::dec) {
+            auto remaining = words;
+            while (true) {
+                unsigned __int128 rest = 0;
+                bool zero = true;
+                for (auto it = remaining.rbegin(); it != remaining.rend(); ++it) {
+                    auto current = (rest << bits) | *it;
+                    *it = static_cast<T>(current / 10);
+                    rest = current % 10;
+                    zero = zero && *it == 0;
+                }
+                result += static_cast<char>('0' + rest);
+                if (zero) {
+                    break;
+                }
+            }
+            std::reverse(result.begin(), result.end());
+            return result;
+        }
+
+        auto step = r == radix::hex ? 4 : 1;
+        auto digits = value_digits(width, r);
+        result.reserve(digits);
+
+        for (size_t i = digits; i > 0; i--) {
+            auto bit = (i - 1) * step;
+            T digit = 0;
+            if (bit / bits < words.size()) {
+                digit = (words[bit / bits] >> (bit % bits)) & ((1 << step) - 1);
+            }
+            result += "0123456789abcdef"[digit];
+        }
+        return result;
+    }
+}
@@ -1,235 +1,321 @@
 #pragma once
 
 #include <vector>
+#include <sstream>
+#include <iomanip>
 #include "util/bits_to_words.h"
 
+#include "util/profiler.h"
+#include "util/time_index.h"
+
+#include "tile_cache.h"
 #include "wave_position.h"
+#include "wave_row.h"
 
 namespace wavy::waveform {
     template<typename T>
     class wave {
     public:
-        wave(const util::bits_to_words<T>& words, const std::vector<uint32_t>& sizes) : m_words(words), m_sizes(sizes), m_start(m_words, m_sizes), m_end(m_words, m_sizes) {
+        wave(const util::bits_to_words<T>& words, const std::vector<uint32_t>& sizes, const util::time_index& index) : m_words(words), m_sizes(sizes), m_index(index), m_start(m_words, m_sizes, m_index), m_end(m_words, m_sizes, m_index) {
             m_start.reset();
             m_end = m_start;
         }
 
-        void set_frame(const size_t columns) {
-            auto duration = columns * m_scale;
-
-            if (duration != m_draw_duration) {
-                set_draw_time(m_draw_start_time, duration, true);
-            }
+        void set_cache(tile_cache* cache) {
+            m_cache = cache;
+            redraw();
         }
 
-        void set_draw_time(const size_t draw_start_time, const size_t draw_duration, const bool force_update) {
-            m_draw_start_time = draw_start_time;
-            m_draw_duration = draw_duration;
-
-            bool update_frame = force_update;
+        void set_profiler(util::profiler* profiler) {
+            m_profiler = profiler;
+        }
 
-            while (m_start.time() + m_start.duration() <= draw_start_time && m_start.move_right()) {
-                update_frame = true;
-            }
-            while (draw_start_time < m_start.time() && m_start.move_left()) {
-                update_frame = true;
+        void set_frame(const size_t columns) {
+            if (columns != m_row.size()) {
+                m_row.resize(columns);
+                redraw();
             }
+        }
 
-            while (m_end.time() + m_end.duration() < draw_start_time + draw_duration && m_end.move_right()) {
-                update_frame = true;
-            }
-            
-            while (draw_start_time + draw_duration < m_end.time() && m_end.move_left()) {
-                update_frame = true;
+        void set_view(const size_t scale, const size_t first_column) {
+            if (scale == m_scale) {
+                scroll_to(first_column);
+            } else {
+                m_scale = scale;
+                m_first_column = first_column;
+                redraw();
             }
+        }
 
-            if (update_frame) {
-                m_frame = draw_frame(m_start, m_end);
+        void invalidate() {
+            if (m_cache != nullptr) {
+                m_cache->erase(&m_words);
             }
-            update_current_frame();
+            redraw();
         }
 
-        void scroll_left(const size_t n) {
-            set_draw_time(m_draw_start_time + m_scale * n, m_draw_duration, false);
+        const std::string& frame() const {
+            return m_current_frame;
         }
 
-        void scroll_right(const size_t n) {
-            if (m_scale * n <= m_draw_start_time) {
-                set_draw_time(m_draw_start_time - m_scale * n, m_draw_duration, false);
-            } else {
-                set_draw_time(0, m_draw_duration, false);
-            }
+        size_t draw_start_time() const {
+            return m_first_column * m_scale;
         }
 
-        void align_with(const wave<T>& other) {
-            m_scale = other.m_scale;
-            m_draw_start_time = other.m_draw_start_time;
-            m_draw_duration = other.m_draw_duration;
-
-            m_start.reset();
-            m_end = m_start;
+        size_t draw_duration() const {
+            return m_row.size() * m_scale;
+        }
 
-            set_draw_time(m_draw_start_time, m_draw_duration, true);
+        std::string draw_frame(wave_position<T>& pos, const size_t from, const size_t to) const {
+            return draw_frame(pos, m_scale, from, to);
         }
 
-        void zoom_in() {
-            if (m_scale > 1) {
-                m_scale /= 2;
+        std::string draw_frame(wave_position<T>& pos, const size_t scale, const size_t from, const size_t to, size_t* visited = nullptr) const {
+            std::string result;
+            result.reserve(to - from);
 
-                m_draw_duration /= 2;
-            }
-            m_start.reset();
-            m_end = m_start;
+            pos.move_to(from * scale);
 
-            set_draw_time(m_draw_start_time, m_draw_duration, true);
-        }
+            auto previous_pos = pos;
+            bool previous = !previous_pos.move_left() || previous_pos.words()[0] != 0;
 
-        void zoom_out() {
-            m_scale *= 2;
-            m_draw_duration *= 2;
+            auto column = from;
+            while (column < to) {
+                auto s = align_time(pos.time(), scale) / scale;
+                auto e = align_time(pos.time() + pos.duration(), scale) / scale;
 
-            m_start.reset();
-            m_end = m_start;
+                if (e > column) {
+                    auto end = std::min(e, to);
+                    if (m_words.width() > 1) {
+                        result += draw_single_fragment(pos.words(), e - s, column - s, end - s);
+                    } else {
+                        result += draw_single_bit(pos.words()[0], previous, e - s, column - s, end - s);
+                    }
+                    column = end;
+                }
 
-            set_draw_time(m_draw_start_time, m_draw_duration, true);
-        }
+                if (column == to) {
+                    break;
+                }
 
-        const std::string& frame() const {
-            return m_current_frame;
+                previous = pos.words()[0] != 0;
+                if (!pos.move_right()) {
+                    result += std::string(to - column, ' ');
+                    break;
+                }
+                if (visited != nullptr) {
+                    (*visited)++;
+                }
+            }
+
+            return result;
         }
-        void update_current_frame() {
-            size_t end_time_of_data = m_end.time() + m_end.duration();
-            size_t end_time_of_draw = m_draw_start_time + m_draw_duration;
 
-            size_t start_time_of_data = m_start.time();
-            size_t start_time_of_draw = m_draw_start_time;
+        std::string draw_tile(const size_t scale, const size_t tile, size_t* visited = nullptr) const {
+            wave_position<T> pos(m_words, m_sizes, m_index);
+            pos.seek(tile * tile_cache::tile_columns * scale);
 
-            size_t remove_from_end = 0;
-            size_t add_to_end = 0;
+            return draw_frame(pos, scale, tile * tile_cache::tile_columns, (tile + 1) * tile_cache::tile_columns, visited);
+        }
 
-            size_t remove_from_start = 0;
-            size_t add_to_start = 0;
+        void prefetch(const size_t scale, const size_t tile) const {
+            tile_cache::key key = {&m_words, scale, tile};
 
-            if (end_time_of_data < end_time_of_draw) {
-                add_to_end = (end_time_of_draw - end_time_of_data) / m_scale;
-            }
-            if (end_time_of_draw < end_time_of_data) {
-                remove_from_end = (end_time_of_data - end_time_of_draw) / m_scale;
+            if (m_cache != nullptr && !m_cache->contains(key)) {
+                m_cache->put(key, draw_tile(scale, tile));
             }
+        }
 
-            if (start_time_of_data < start_time_of_draw) {
-                remove_from_start = (start_time_of_draw - start_time_of_data) / m_scale;
-            }
-            if (start_time_of_draw < start_time_of_data) {
-                add_to_start = (start_time_of_data - start_time_of_draw) / m_scale;
-            }
+        std::vector<std::pair<size_t, size_t>> prefetch_tiles() const {
+            std::vector<std::pair<size_t, size_t>> result;
 
-            auto extended_frame = m_frame + std::string(add_to_end, ' ');
-            m_current_frame = std::string(add_to_start, ' ') + extended_frame.substr(remove_from_start, extended_frame.length() - remove_from_start - remove_from_end);
-        }
+            auto first = m_first_column / tile_cache::tile_columns;
+            auto last = (m_first_column + m_row.size()) / tile_cache::tile_columns;
 
-        std::string draw_frame(const wave_position<T>& start, const wave_position<T>& end) {
-            std::string result;
+            if (first > 0) {
+                result.push_back({m_scale, first - 1});
+            }
+            result.push_back({m_scale, last + 1});
 
-            wave_position<T> current_pos = start;
-            while (true) {
-                auto s = align_time(current_pos.time());
-                auto e = align_time(current_pos.time() + current_pos.duration());
-                auto duration = e - s;
-                int len = duration / m_scale;
+            auto start = draw_start_time();
+            auto duration = draw_duration();
+            auto from = start - std::min(start, duration / 2);
+            auto to = start + duration + duration / 2;
 
-                if (len > 0) {
-                    if (m_words.width() > 1) {
-                        result += draw_single_fragment(current_pos.words(), len);
-                    } else {
-                        result += draw_single_bit(current_pos.words()[0], len);
+            for (auto scale : {m_scale * 2, m_scale / 2}) {
+                if (scale > 0) {
+                    for (auto tile = from / scale / tile_cache::tile_columns; tile <= to / scale / tile_cache::tile_columns; tile++) {
+                        result.push_back({scale, tile});
                     }
                 }
-                
-                if (current_pos == end) {
-                    return result;
-                }
-                current_pos.move_right();
             }
+
+            return result;
         }
 
-        size_t& scale() {
+        size_t scale() const {
             return m_scale;
         }
+
+        size_t memory_usage() const {
+            return m_row.memory_usage() + m_current_frame.capacity();
+        }
     private:
-        size_t align_time(const size_t time) const {
-            auto m = time % m_scale;
+        std::string draw_columns(wave_position<T>& pos, const size_t from, const size_t to) {
+            size_t visited = 0;
+            util::profiler::timer timer(m_profiler, &util::profiler::frame_counters::draw_us);
+
+            if (m_cache == nullptr) {
+                auto result = draw_frame(pos, m_scale, from, to, &visited);
+                count_transitions(visited);
+                return result;
+            }
+
+            std::string result;
+            result.reserve(to - from);
+
+            for (auto tile = from / tile_cache::tile_columns; tile * tile_cache::tile_columns < to; tile++) {
+                tile_cache::key key = {&m_words, m_scale, tile};
+                auto cached = m_cache->get(key);
+                if (!cached) {
+                    cached = draw_tile(m_scale, tile, &visited);
+                    m_cache->put(key, *cached);
+                }
+
+                auto tile_start = tile * tile_cache::tile_columns;
+                auto first = std::max(from, tile_start);
+                auto last = std::min(to, tile_start + tile_cache::tile_columns);
+                result.append(*cached, first - tile_start, last - first);
+            }
+            count_transitions(visited);
+
+            return result;
+        }
+
+        void count_transitions(const size_t visited) {
+            if (m_profiler != nullptr) {
+                m_profiler->current().transitions += visited;
+            }
+        }
+
+        void scroll_to(const size_t first_column) {
+            auto columns = m_row.size();
+
+            if (first_column > m_first_column && first_column - m_first_column < columns) {
+                m_row.push_back(draw_columns(m_end, m_first_column + columns, first_column + columns));
+                m_first_column = first_column;
+            } else if (first_column < m_first_column && m_first_column - first_column < columns) {
+                m_row.push_front(draw_columns(m_start, first_column, m_first_column));
+                m_first_column = first_column;
+            } else if (first_column != m_first_column) {
+                m_first_column = first_column;
+                redraw();
+                return;
+            }
+
+            update_positions();
+            m_row.copy_to(m_current_frame);
+        }
+
+        void update_positions() {
+            m_start.seek(draw_start_time());
+            m_end.seek(draw_start_time() + draw_duration() - std::min(draw_duration(), m_scale));
+        }
+
+        void redraw() {
+            update_positions();
+
+            auto pos = m_start;
+            m_row.assign(draw_columns(pos, m_first_column, m_first_column + m_row.size()));
+            m_row.copy_to(m_current_frame);
+        }
+
+        size_t align_time(const size_t time, const size_t scale) const {
+            auto m = time % scale;
 
             if (m == 0) {
                 return time;
             } else {
-                return time - m + m_scale;
+                return time - m + scale;
             }
         }
-        
-        std::string draw_single_fragment(const std::vector<T>& words, const uint32_t len) const {
+
+        std::string label(const std::vector<T>& words) const {
             std::stringstream sstream;
+            sstream << std::hex;
+            bool leading = true;
             for (auto it = words.rbegin(); it != words.rend(); ++it) {
-                sstream << std::hex << *it;
+                if (leading && *it == 0 && std::next(it) != words.rend()) {
+                    continue;
+                }
+                if (!leading) {
+                    sstream << std::setw(sizeof(T) * 2) << std::setfill('0');
+                }
+                sstream << *it;
+                leading = false;
             }
-            std::string label = sstream.str();
+            return sstream.str();
+        }
+
+        std::string draw_single_fragment(const std::vector<T>& words, const size_t len, const size_t from, const size_t to) const {
+            std::string result(to - from, ' ');
 
+            if (from == 0) {
+                result[0] = '|';
+            }
             if (len <= 1) {
-                return "|";
+                return result;
             }
 
-            if (len < 1 + label.length()) {
-                int show_label_length = std::max(0, static_cast<int>(len) - 4);
-                if (show_label_length > 0) {
-                    return "|" + std::string(std::min(3U, len - 1), '.') + label.substr(label.length() - show_label_length, show_label_length);
-                } else {
-                    return "|" + std::string(std::min(3U, len - 1), '.');
-                }
+            auto text = label(words);
+            size_t text_start;
+
+            if (len < 1 + text.length()) {
+                auto dots = std::min<size_t>(3, len - 1);
+                text = std::string(dots, '.') + text.substr(text.length() - std::max<int>(0, static_cast<int>(len) - 4));
+                text_start = 1;
             } else {
-                int space = len - 1 - label.length();
-                int left_space = space / 2;
-                int right_space = space - left_space;
+                text_start = 1 + (len - 1 - text.length()) / 2;
+            }
 
-                return "|" + std::string(left_space, ' ') + label + std::string(right_space, ' ');
+            auto first = std::max(from, text_start);
+            auto last = std::min(to, text_start + text.length());
+            if (first < last) {
+                result.replace(first - from, last - first, text, first - text_start, last - first);
             }
 
-            return std::string(len, 'X');
+            return result;
         }
 
-        std::string draw_single_bit(const int s, const uint32_t len) {
-            if (len <= 1) {
-                return "|";
-            }
+        std::string draw_single_bit(const T s, const bool previous, const size_t len, const size_t from, const size_t to) const {
+            std::string result(to - from, s == 0 ? '_' : '#');
 
-            if (s == 0) {
-                std::string result(len - 1, '_');
-                if (m_last == 1) {
-                    m_last = 0;
-                    return "\\" + result;
+            if (from == 0) {
+                if (len <= 1) {
+                    result[0] = '|';
+                } else if (s == 0 && previous) {
+                    result[0] = '\\';
+                } else if (s != 0 && !previous) {
+                    result[0] = '/';
                 }
-                return "_" + result;
-            } else {
-                std::string result(len - 1, '#');
-                if (m_last == 0) {
-                    m_last = 1;
-                    return "/" + result;
-                }
-                return "#" + result;
             }
+
+            return result;
         }
 
-        std::string m_frame;
+        wave_row m_row;
         std::string m_current_frame;
-        int m_last = 1;
 
         const util::bits_to_words<T>& m_words;
         const std::vector<uint32_t>& m_sizes;
+        const util::time_index& m_index;
+        tile_cache* m_cache = nullptr;
+        util::profiler* m_profiler = nullptr;
 
         wave_position<T> m_start;
         wave_position<T> m_end;
 
-        size_t m_draw_start_time = 0;
-        size_t m_draw_duration;
+        size_t m_first_column = 0;
         size_t m_scale = 1024;
     };
 }
@@ -2,16 +2,31 @@
 
 #include <vector>
 #include "util/bits_to_words.h"
+#include "util/time_index.h"
 
 namespace wavy::waveform {
     template<typename T>
     struct wave_position {
-        wave_position(const util::bits_to_words<T>& words, const std::vector<uint32_t>& sizes) : m_words(words), m_sizes(sizes) {}
+        wave_position(const util::bits_to_words<T>& words, const std::vector<uint32_t>& sizes, const util::time_index& index) : m_words(words), m_sizes(sizes), m_index(index) {}
         void reset() {
             m_time = 0;
             m_word_pos = m_words.begin();
             m_size_pos = m_sizes.begin();
         }
+        void seek(const size_t time) {
+            auto [item, start] = m_index.find(time / 1024);
+
+            m_time = start;
+            m_word_pos = m_words.at(item);
+            m_size_pos = m_sizes.begin() + item;
+
+            while (this->time() + duration() <= time && move_right()) {}
+        }
+        void seek_block(const size_t block) {
+            m_time = m_index.block_start(block);
+            m_word_pos = m_words.at(block * util::time_index::block_size);
+            m_size_pos = m_sizes.begin() + block * util::time_index::block_size;
+        }
         bool move_left() {
             if (m_word_pos != m_words.begin() && m_size_pos != m_sizes.begin()) {
                 --m_word_pos;
@@ -34,6 +49,31 @@ namespace wavy::waveform {
 
             return false;
         }
+        bool next_change() {
+            auto value = words();
+            while (move_right()) {
+                if (words() != value) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        bool run_start() {
+            while (true) {
+                auto value = words();
+                if (!move_left()) {
+                    return false;
+                }
+                if (words() != value) {
+                    move_right();
+                    return true;
+                }
+            }
+        }
+        void move_to(const size_t time) {
+            while (time < this->time() && move_left()) {}
+            while (this->time() + duration() <= time && move_right()) {}
+        }
 
         size_t time() const {
             return m_time * 1024;
@@ -43,6 +83,10 @@ namespace wavy::waveform {
             return *m_size_pos * 1024;
         }
 
+        size_t item() const {
+            return std::distance(m_sizes.begin(), m_size_pos);
+        }
+
         const std::vector<T>& words() const {
             return *m_word_pos;
         }
@@ -64,5 +108,6 @@ namespace wavy::waveform {
         
         const util::bits_to_words<T>& m_words;
         const std::vector<uint32_t>& m_sizes;
+        const util::time_index& m_index;
     };
 }
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+
+namespace wavy::waveform {
+    class wave_row {
+    public:
+        void resize(const size_t columns) {
+            m_data.assign(columns, ' ');
+            m_head = 0;
+        }
+
+        size_t size() const {
+            return m_data.size();
+        }
+
+        size_t memory_usage() const {
+            return m_data.capacity();
+        }
+
+        void assign(const std::string& s) {
+            m_data.assign(m_data.size(), ' ');
+            std::copy_n(s.begin(), std::min(s.length(), m_data.size()), m_data.begin());
+            m_head = 0;
+        }
+
+        void push_back(const std::string& s) {
+            write(m_head, s);
+            m_head = (m_head + s.length()) % m_data.size();
+        }
+
+        void push_front(const std::string& s) {
+            m_head = (m_head + m_data.size() - s.length()) % m_data.size();
+            write(m_head, s);
+        }
+
+        void copy_to(std::string& dest) const {
+            dest.assign(m_data, m_head);
+            dest.append(m_data, 0, m_head);
+        }
+    private:
+        void write(const size_t pos, const std::string& s) {
+            auto first = std::min(s.length(), m_data.size() - pos);
+            std::copy_n(s.begin(), first, m_data.begin() + pos);
+            std::copy_n(s.begin() + first, s.length() - first, m_data.begin());
+        }
+
+        std::string m_data;
+        size_t m_head = 0;
+    };
+}